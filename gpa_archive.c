@@ -0,0 +1,490 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_archive.h"
+
+static const char archiveMagic[8] = {'G', 'P', 'A', 'A', 'R', 'C', 'H', '1'};
+
+// Longest encoding of one record plus its student run header
+#define MAX_RECORD_BYTES 21
+
+static int growBytes(unsigned char **data, size_t *capacity, size_t needed) {
+    size_t size = *capacity > 0 ? *capacity : 4096;
+    unsigned char *grown;
+
+    if (needed <= *capacity) return 1;
+    while (size < needed) size *= 2;
+    grown = realloc(*data, size);
+    if (grown == NULL) return 0;
+    *data = grown;
+    *capacity = size;
+    return 1;
+}
+
+static unsigned char *writeVarint(unsigned char *p, unsigned int value) {
+    while (value >= 0x80) {
+        *p++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (unsigned char)value;
+    return p;
+}
+
+// Unchecked; only used on blocks that were written here or validated on load
+static const unsigned char *readVarint(const unsigned char *p, unsigned int *value) {
+    unsigned int result = *p++;
+    int shift = 7;
+
+    if (result < 0x80) {
+        *value = result;
+        return p;
+    }
+    result &= 0x7F;
+    for (;;) {
+        unsigned int byte = *p++;
+        result |= (byte & 0x7F) << shift;
+        if (byte < 0x80) break;
+        shift += 7;
+    }
+    *value = result;
+    return p;
+}
+
+// Bounds-checked variant for loading files; returns NULL on a bad varint
+static const unsigned char *readVarintChecked(const unsigned char *p, const unsigned char *end, unsigned int *value) {
+    unsigned int result = 0;
+    int shift;
+
+    for (shift = 0; shift < 35 && p < end; shift += 7) {
+        unsigned int byte = *p++;
+        result |= (byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            *value = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static int gradeCode(const char *letterGrade) {
+    int i;
+    for (i = 0; i < GRADE_COUNT; i++) {
+        if (strcmp(gradeLetters[i], letterGrade) == 0) return i;
+    }
+    return ARCHIVE_NO_GRADE;
+}
+
+static unsigned int hashName(const char *name) {
+    unsigned int hash = 2166136261u;
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int archiveInit(Archive *archive) {
+    memset(archive, 0, sizeof(*archive));
+    archive->pending = malloc(sizeof(ArchiveRecord) * ARCHIVE_BLOCK_RECORDS);
+    return archive->pending != NULL;
+}
+
+void archiveFree(Archive *archive) {
+    free(archive->names);
+    free(archive->nameOffsets);
+    free(archive->hashSlots);
+    free(archive->data);
+    free(archive->blocks);
+    free(archive->pending);
+    memset(archive, 0, sizeof(*archive));
+}
+
+static int rehashCatalog(Archive *archive, int hashSize) {
+    int *slots = malloc(sizeof(int) * hashSize);
+    int i;
+
+    if (slots == NULL) return 0;
+    for (i = 0; i < hashSize; i++) slots[i] = -1;
+    for (i = 0; i < archive->courseCount; i++) {
+        unsigned int slot = hashName(archive->names + archive->nameOffsets[i]) & (hashSize - 1);
+        while (slots[slot] >= 0) slot = (slot + 1) & (hashSize - 1);
+        slots[slot] = i;
+    }
+    free(archive->hashSlots);
+    archive->hashSlots = slots;
+    archive->hashSize = hashSize;
+    return 1;
+}
+
+// Add a name to the catalog (no lookup); returns its id or -1
+static int appendCourseName(Archive *archive, const char *name, size_t length) {
+    if (archive->courseCount == archive->courseCapacity) {
+        int capacity = archive->courseCapacity > 0 ? archive->courseCapacity * 2 : 256;
+        size_t *grown = realloc(archive->nameOffsets, sizeof(size_t) * capacity);
+        if (grown == NULL) return -1;
+        archive->nameOffsets = grown;
+        archive->courseCapacity = capacity;
+    }
+    if (!growBytes((unsigned char **)&archive->names, &archive->namesCapacity, archive->namesLength + length + 1)) {
+        return -1;
+    }
+    memcpy(archive->names + archive->namesLength, name, length);
+    archive->names[archive->namesLength + length] = '\0';
+    archive->nameOffsets[archive->courseCount] = archive->namesLength;
+    archive->namesLength += length + 1;
+    return archive->courseCount++;
+}
+
+// Catalog id of a course name, adding it on first use; -1 when out of memory
+static int internCourse(Archive *archive, const char *name) {
+    unsigned int slot;
+    int id;
+
+    // Keep the table at most half full
+    if ((archive->courseCount + 1) * 2 > archive->hashSize &&
+        !rehashCatalog(archive, archive->hashSize > 0 ? archive->hashSize * 2 : 1024)) {
+        return -1;
+    }
+
+    slot = hashName(name) & (archive->hashSize - 1);
+    while ((id = archive->hashSlots[slot]) >= 0) {
+        if (strcmp(archive->names + archive->nameOffsets[id], name) == 0) return id;
+        slot = (slot + 1) & (archive->hashSize - 1);
+    }
+
+    id = appendCourseName(archive, name, strlen(name));
+    if (id >= 0) archive->hashSlots[slot] = id;
+    return id;
+}
+
+const char *archiveCourseName(const Archive *archive, unsigned int courseId) {
+    if (courseId >= (unsigned int)archive->courseCount) return "";
+    return archive->names + archive->nameOffsets[courseId];
+}
+
+// Encode the pending records as one block
+static int flushBlock(Archive *archive) {
+    const ArchiveRecord *records = archive->pending;
+    int count = archive->pendingCount;
+    unsigned char *p;
+    unsigned int previous;
+    ArchiveBlock *block;
+    int i, run;
+
+    if (count == 0) return 1;
+    if (archive->blockCount == archive->blockCapacity) {
+        int capacity = archive->blockCapacity > 0 ? archive->blockCapacity * 2 : 64;
+        ArchiveBlock *grown = realloc(archive->blocks, sizeof(ArchiveBlock) * capacity);
+        if (grown == NULL) return 0;
+        archive->blocks = grown;
+        archive->blockCapacity = capacity;
+    }
+    if (!growBytes(&archive->data, &archive->capacity, archive->length + (size_t)count * MAX_RECORD_BYTES)) {
+        return 0;
+    }
+
+    block = &archive->blocks[archive->blockCount++];
+    block->firstStudent = records[0].studentId;
+    block->lastStudent = records[count - 1].studentId;
+    block->recordCount = count;
+    block->offset = archive->length;
+
+    p = archive->data + archive->length;
+    previous = records[0].studentId;
+    for (i = 0; i < count; i = run) {
+        // One run per student
+        run = i + 1;
+        while (run < count && records[run].studentId == records[i].studentId) run++;
+        p = writeVarint(p, records[i].studentId - previous);
+        p = writeVarint(p, (unsigned int)(run - i));
+        previous = records[i].studentId;
+
+        for (; i < run; i++) {
+            int credits = records[i].creditHours;
+            *p++ = (unsigned char)(records[i].grade << 4 | (credits < 16 ? credits : 0));
+            if (credits >= 16) p = writeVarint(p, (unsigned int)credits);
+            p = writeVarint(p, records[i].courseId);
+        }
+    }
+
+    block->length = (size_t)(p - (archive->data + block->offset));
+    archive->length += block->length;
+    archive->recordCount += count;
+    archive->pendingCount = 0;
+    return 1;
+}
+
+// Append one student's courses; ids must not decrease. Returns 0 on error.
+int archiveAddStudent(Archive *archive, unsigned int studentId, const Student *student) {
+    int i;
+
+    if (archive->recordCount + archive->pendingCount > 0 && studentId < archive->lastStudent) return 0;
+    archive->lastStudent = studentId;
+
+    for (i = 0; i < student->courseCount; i++) {
+        const Course *course = &student->courses[i];
+        ArchiveRecord *record;
+        int grade = gradeCode(course->letterGrade);
+        int courseId;
+
+        if (grade == ARCHIVE_NO_GRADE || course->creditHours <= 0) {
+            archive->skipped++;
+            continue;
+        }
+        courseId = internCourse(archive, course->name);
+        if (courseId < 0) return 0;
+
+        if (archive->pendingCount == ARCHIVE_BLOCK_RECORDS && !flushBlock(archive)) return 0;
+        record = &archive->pending[archive->pendingCount++];
+        record->studentId = studentId;
+        record->courseId = (unsigned int)courseId;
+        record->creditHours = course->creditHours;
+        record->grade = grade;
+    }
+    return 1;
+}
+
+// Encode the last partial block; call once after the final archiveAddStudent
+int archiveFinish(Archive *archive) {
+    return flushBlock(archive);
+}
+
+// Decode one block into records (room for ARCHIVE_BLOCK_RECORDS); returns the count
+int archiveDecodeBlock(const Archive *archive, int blockIndex, ArchiveRecord *records) {
+    const ArchiveBlock *block = &archive->blocks[blockIndex];
+    const unsigned char *p = archive->data + block->offset;
+    const unsigned char *end = p + block->length;
+    unsigned int studentId = block->firstStudent;
+    int n = 0;
+
+    while (p < end) {
+        unsigned int delta, count, value;
+        ArchiveRecord *record;
+
+        p = readVarint(p, &delta);
+        p = readVarint(p, &count);
+        studentId += delta;
+
+        for (record = records + n, n += (int)count; record < records + n; record++) {
+            unsigned int packed = *p++;
+            record->studentId = studentId;
+            record->grade = (int)(packed >> 4);
+            record->creditHours = (int)(packed & 0x0F);
+            if (record->creditHours == 0) {
+                p = readVarint(p, &value);
+                record->creditHours = (int)value;
+            }
+            p = readVarint(p, &record->courseId);
+        }
+    }
+    return n;
+}
+
+// Decode every block in order, handing each to fn
+int archiveScan(const Archive *archive, ArchiveBlockFn fn, void *context) {
+    ArchiveRecord *records = malloc(sizeof(ArchiveRecord) * ARCHIVE_BLOCK_RECORDS);
+    int i;
+
+    if (records == NULL) return 0;
+    for (i = 0; i < archive->blockCount; i++) {
+        int count = archiveDecodeBlock(archive, i, records);
+        fn(context, records, count);
+    }
+    free(records);
+    return 1;
+}
+
+// Rebuild the courses and GPA of one student; the name is left to the caller.
+// Returns 0 when the archive has no records for studentId.
+int archiveReadStudent(const Archive *archive, unsigned int studentId, Student *student) {
+    ArchiveRecord *records;
+    int low = 0, high = archive->blockCount;
+    int i, b;
+
+    student->courseCount = 0;
+    student->gpa = 0.0f;
+
+    // First block that can hold studentId
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (archive->blocks[mid].lastStudent < studentId) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == archive->blockCount || archive->blocks[low].firstStudent > studentId) return 0;
+
+    records = malloc(sizeof(ArchiveRecord) * ARCHIVE_BLOCK_RECORDS);
+    if (records == NULL) return 0;
+
+    // A student's courses may continue into the next blocks
+    for (b = low; b < archive->blockCount && archive->blocks[b].firstStudent <= studentId; b++) {
+        int count = archiveDecodeBlock(archive, b, records);
+        for (i = 0; i < count && student->courseCount < MAX_COURSES; i++) {
+            Course *course;
+            if (records[i].studentId != studentId) continue;
+            course = &student->courses[student->courseCount++];
+            snprintf(course->name, NAME_LENGTH, "%s", archiveCourseName(archive, records[i].courseId));
+            strcpy(course->letterGrade, gradeLetters[records[i].grade]);
+            course->creditHours = records[i].creditHours;
+        }
+    }
+    free(records);
+
+    computeStudentGPA(student, NULL);
+    return student->courseCount > 0;
+}
+
+// File layout: magic, catalog, block index, then the block data, all
+// integers as varints
+int archiveSave(const Archive *archive, const char *path) {
+    unsigned char *header = NULL;
+    size_t capacity = 0;
+    unsigned char *p;
+    size_t needed;
+    FILE *file;
+    int i, ok;
+
+    needed = sizeof(archiveMagic) + 20 + (size_t)archive->courseCount * 5 + archive->namesLength +
+             (size_t)archive->blockCount * 15;
+    if (!growBytes(&header, &capacity, needed)) return 0;
+
+    p = header;
+    memcpy(p, archiveMagic, sizeof(archiveMagic));
+    p += sizeof(archiveMagic);
+    p = writeVarint(p, (unsigned int)archive->courseCount);
+    for (i = 0; i < archive->courseCount; i++) {
+        const char *name = archive->names + archive->nameOffsets[i];
+        size_t length = strlen(name);
+        p = writeVarint(p, (unsigned int)length);
+        memcpy(p, name, length);
+        p += length;
+    }
+    p = writeVarint(p, (unsigned int)archive->blockCount);
+    for (i = 0; i < archive->blockCount; i++) {
+        p = writeVarint(p, archive->blocks[i].firstStudent);
+        p = writeVarint(p, (unsigned int)archive->blocks[i].recordCount);
+        p = writeVarint(p, (unsigned int)archive->blocks[i].length);
+    }
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        free(header);
+        return 0;
+    }
+    ok = fwrite(header, 1, (size_t)(p - header), file) == (size_t)(p - header) &&
+         fwrite(archive->data, 1, archive->length, file) == archive->length;
+    ok = fclose(file) == 0 && ok;
+    free(header);
+    return ok;
+}
+
+// Walk a loaded block with bounds checks; sets lastStudent. Returns 0 if malformed.
+static int validateBlock(ArchiveBlock *block, const unsigned char *data, int courseCount) {
+    const unsigned char *p = data + block->offset;
+    const unsigned char *end = p + block->length;
+    unsigned int studentId = block->firstStudent;
+    int records = 0;
+
+    while (p != NULL && p < end) {
+        unsigned int delta, count, value, i;
+
+        p = readVarintChecked(p, end, &delta);
+        if (p != NULL) p = readVarintChecked(p, end, &count);
+        if (p == NULL || count == 0 || count > (unsigned int)(block->recordCount - records)) return 0;
+        studentId += delta;
+        records += (int)count;
+
+        for (i = 0; i < count && p != NULL; i++) {
+            unsigned int packed;
+            if (p >= end) return 0;
+            packed = *p++;
+            if ((packed >> 4) >= GRADE_COUNT) return 0;
+            if ((packed & 0x0F) == 0) p = readVarintChecked(p, end, &value);
+            if (p != NULL) p = readVarintChecked(p, end, &value);
+            if (p != NULL && value >= (unsigned int)courseCount) return 0;
+        }
+    }
+    block->lastStudent = studentId;
+    return p == end && records == block->recordCount;
+}
+
+static int loadArchive(Archive *archive, const unsigned char *bytes, size_t size) {
+    const unsigned char *p = bytes + sizeof(archiveMagic);
+    const unsigned char *end = bytes + size;
+    unsigned int courseCount, blockCount, value, i;
+    size_t offset = 0;
+    int hashSize = 1024;
+
+    if (size < sizeof(archiveMagic) || memcmp(bytes, archiveMagic, sizeof(archiveMagic)) != 0) return 0;
+
+    p = readVarintChecked(p, end, &courseCount);
+    for (i = 0; p != NULL && i < courseCount; i++) {
+        p = readVarintChecked(p, end, &value);
+        if (p == NULL || value > (size_t)(end - p) || value >= NAME_LENGTH) return 0;
+        if (appendCourseName(archive, (const char *)p, value) < 0) return 0;
+        p += value;
+    }
+    if (p == NULL) return 0;
+    while ((archive->courseCount + 1) * 2 > hashSize) hashSize *= 2;
+    if (!rehashCatalog(archive, hashSize)) return 0;
+
+    p = readVarintChecked(p, end, &blockCount);
+    if (p == NULL) return 0;
+    archive->blocks = malloc(sizeof(ArchiveBlock) * (blockCount > 0 ? blockCount : 1));
+    if (archive->blocks == NULL) return 0;
+    archive->blockCapacity = (int)blockCount;
+    for (i = 0; i < blockCount; i++) {
+        ArchiveBlock *block = &archive->blocks[i];
+        unsigned int records, length;
+
+        p = readVarintChecked(p, end, &block->firstStudent);
+        if (p != NULL) p = readVarintChecked(p, end, &records);
+        if (p != NULL) p = readVarintChecked(p, end, &length);
+        if (p == NULL || records == 0 || records > ARCHIVE_BLOCK_RECORDS) return 0;
+        block->recordCount = (int)records;
+        block->offset = offset;
+        block->length = length;
+        offset += length;
+        archive->blockCount++;
+    }
+    if (offset != (size_t)(end - p)) return 0;
+
+    if (!growBytes(&archive->data, &archive->capacity, offset > 0 ? offset : 1)) return 0;
+    memcpy(archive->data, p, offset);
+    archive->length = offset;
+
+    for (i = 0; i < blockCount; i++) {
+        ArchiveBlock *block = &archive->blocks[i];
+        if (!validateBlock(block, archive->data, archive->courseCount)) return 0;
+        if (i > 0 && block->firstStudent < archive->blocks[i - 1].lastStudent) return 0;
+        archive->recordCount += block->recordCount;
+    }
+    archive->lastStudent = blockCount > 0 ? archive->blocks[blockCount - 1].lastStudent : 0;
+    return 1;
+}
+
+// Load an archive written by archiveSave; more students may be appended after it
+int archiveLoad(Archive *archive, const char *path) {
+    FILE *file = fopen(path, "rb");
+    unsigned char *bytes;
+    long size;
+    int ok = 0;
+
+    if (file == NULL || !archiveInit(archive)) {
+        if (file != NULL) fclose(file);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bytes = size > 0 ? malloc((size_t)size) : NULL;
+    if (bytes != NULL && fread(bytes, 1, (size_t)size, file) == (size_t)size) {
+        ok = loadArchive(archive, bytes, (size_t)size);
+    }
+    fclose(file);
+    free(bytes);
+    if (!ok) archiveFree(archive);
+    return ok;
+}
@@ -0,0 +1,76 @@
+#ifndef GPA_ARCHIVE_H
+#define GPA_ARCHIVE_H
+
+#include <stddef.h>
+#include "gpa_core.h"
+
+// Packed storage for archived course records (alumni, past terms). A
+// Course takes 112 bytes in memory; archived, a record is about 3:
+//
+//   per student run:  varint student id delta, varint course count
+//   per course:       byte  grade code << 4 | credit hours (0 = varint follows)
+//                     varint course id
+//
+// Course names are interned once in a catalog and referenced by id. Records
+// are grouped into independently decodable blocks of up to
+// ARCHIVE_BLOCK_RECORDS, each starting from an absolute student id, so a
+// report can decode one block, a range, or the whole archive in a stream.
+
+#define ARCHIVE_BLOCK_RECORDS 4096
+#define ARCHIVE_NO_GRADE 15
+
+// One decoded course record
+typedef struct {
+    unsigned int studentId;
+    unsigned int courseId;
+    int creditHours;
+    int grade;              // Index into gradeLetters
+} ArchiveRecord;
+
+typedef struct {
+    unsigned int firstStudent;
+    unsigned int lastStudent;
+    int recordCount;
+    size_t offset;          // Into Archive.data
+    size_t length;
+} ArchiveBlock;
+
+typedef struct {
+    // Course catalog: id -> name, with a hash index for interning
+    char *names;
+    size_t namesLength, namesCapacity;
+    size_t *nameOffsets;
+    int courseCount, courseCapacity;
+    int *hashSlots;
+    int hashSize;
+
+    // Encoded blocks
+    unsigned char *data;
+    size_t length, capacity;
+    ArchiveBlock *blocks;
+    int blockCount, blockCapacity;
+    long long recordCount;
+    long long skipped;      // Courses whose grade is not in gradeLetters
+
+    // Block being written
+    ArchiveRecord *pending;
+    int pendingCount;
+    unsigned int lastStudent;
+} Archive;
+
+typedef void (*ArchiveBlockFn)(void *context, const ArchiveRecord *records, int count);
+
+int archiveInit(Archive *archive);
+void archiveFree(Archive *archive);
+int archiveAddStudent(Archive *archive, unsigned int studentId, const Student *student);
+int archiveFinish(Archive *archive);
+const char *archiveCourseName(const Archive *archive, unsigned int courseId);
+
+int archiveDecodeBlock(const Archive *archive, int block, ArchiveRecord *records);
+int archiveScan(const Archive *archive, ArchiveBlockFn fn, void *context);
+int archiveReadStudent(const Archive *archive, unsigned int studentId, Student *student);
+
+int archiveSave(const Archive *archive, const char *path);
+int archiveLoad(Archive *archive, const char *path);
+
+#endif
@@ -0,0 +1,206 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_archive.h"
+#include "gpa_import.h"
+#include "gpa_roster_gen.h"
+#include "gpa_timer.h"
+
+// Packs rosters into the archive format and runs reports over archives.
+
+typedef struct {
+    long long records;
+    long long students;
+    long long credits;
+    double points;
+    long long gradeCounts[GRADE_COUNT];
+    unsigned int lastStudent;
+} Report;
+
+static void reportBlock(void *context, const ArchiveRecord *records, int count) {
+    Report *report = context;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        const ArchiveRecord *record = &records[i];
+        if (record->studentId != report->lastStudent || report->records == 0) report->students++;
+        report->lastStudent = record->studentId;
+        report->records++;
+        report->credits += record->creditHours;
+        report->points += letterGradeToPoints(gradeLetters[record->grade]) * record->creditHours;
+        report->gradeCounts[record->grade]++;
+    }
+}
+
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (file == NULL) return NULL;
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    data = malloc((size_t)size + 1);
+    if (data != NULL) {
+        *length = fread(data, 1, (size_t)size, file);
+        data[*length] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+static int pack(const char *out, const char *rosterPath, int generate, unsigned long long seed) {
+    Archive archive;
+    int students = 0;
+
+    if (!archiveInit(&archive)) return 0;
+    long long start = nowNanoseconds();
+
+    if (rosterPath != NULL) {
+        size_t length;
+        char *text = readFile(rosterPath, &length);
+        if (text == NULL) {
+            fprintf(stderr, "Cannot read %s\n", rosterPath);
+            archiveFree(&archive);
+            return 0;
+        }
+        int maxStudents = 1;
+        for (size_t i = 0; i < length; i++) maxStudents += text[i] == '\n';
+        Student *roster = malloc(sizeof(Student) * maxStudents);
+        int added = 0, complete = 0;
+        if (roster != NULL) {
+            students = importRoster(text, length, roster, maxStudents, NULL);
+            while (added < students && archiveAddStudent(&archive, (unsigned int)added, &roster[added])) added++;
+            complete = added == students;
+        }
+        free(roster);
+        free(text);
+        if (!complete) {
+            fprintf(stderr, "Out of memory after %d students\n", added);
+            archiveFree(&archive);
+            return 0;
+        }
+    } else {
+        // Streamed, so the roster never has to fit in memory
+        RosterGenOptions options;
+        RosterGen gen;
+        Student student;
+        rosterGenDefaults(&options);
+        options.seed = seed;
+        rosterGenInit(&gen, &options);
+        for (students = 0; students < generate; students++) {
+            rosterGenStudent(&gen, &student);
+            if (!archiveAddStudent(&archive, (unsigned int)students, &student)) {
+                fprintf(stderr, "Out of memory after %d students\n", students);
+                archiveFree(&archive);
+                return 0;
+            }
+        }
+    }
+
+    if (!archiveFinish(&archive) || !archiveSave(&archive, out)) {
+        fprintf(stderr, "Cannot write %s\n", out);
+        archiveFree(&archive);
+        return 0;
+    }
+    long long elapsed = nowNanoseconds() - start;
+
+    printf("{\"students\":%d,\"records\":%lld,\"skipped\":%lld,\"courses\":%d,\"blocks\":%d,\"bytes\":%zu,"
+           "\"bytes_per_record\":%.2f,\"ratio\":%.1f,\"ms\":%.1f}\n",
+           students, archive.recordCount, archive.skipped, archive.courseCount, archive.blockCount, archive.length,
+           archive.recordCount > 0 ? (double)archive.length / archive.recordCount : 0.0,
+           archive.length > 0 ? (double)archive.recordCount * sizeof(Course) / archive.length : 0.0, elapsed / 1e6);
+    archiveFree(&archive);
+    return 1;
+}
+
+static int report(const char *path) {
+    Archive archive;
+    Report totals;
+
+    if (!archiveLoad(&archive, path)) {
+        fprintf(stderr, "Cannot load %s\n", path);
+        return 0;
+    }
+    memset(&totals, 0, sizeof(totals));
+    long long start = nowNanoseconds();
+    archiveScan(&archive, reportBlock, &totals);
+    long long elapsed = nowNanoseconds() - start;
+
+    printf("{\"students\":%lld,\"records\":%lld,\"mean_gpa\":%.3f,\"grades\":[", totals.students, totals.records,
+           totals.credits > 0 ? totals.points / totals.credits : 0.0);
+    for (int i = 0; i < GRADE_COUNT; i++) printf("%s%lld", i > 0 ? "," : "", totals.gradeCounts[i]);
+    printf("],\"decode_ms\":%.1f,\"records_per_sec\":%.0f,\"mb_per_sec\":%.0f}\n", elapsed / 1e6,
+           elapsed > 0 ? totals.records * 1e9 / elapsed : 0.0,
+           elapsed > 0 ? archive.length * 1e3 / elapsed : 0.0);
+    archiveFree(&archive);
+    return 1;
+}
+
+static int showStudent(const char *path, unsigned int id) {
+    Archive archive;
+    Student student;
+    char line[256];
+
+    if (!archiveLoad(&archive, path)) {
+        fprintf(stderr, "Cannot load %s\n", path);
+        return 0;
+    }
+    if (!archiveReadStudent(&archive, id, &student)) {
+        fprintf(stderr, "No records for student %u\n", id);
+        archiveFree(&archive);
+        return 0;
+    }
+    for (int i = 0; i < student.courseCount; i++) {
+        formatCourseEntry(line, sizeof(line), &student.courses[i]);
+        printf("%s\n", line);
+    }
+    printf("GPA: %.2f\n", student.gpa);
+    archiveFree(&archive);
+    return 1;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s pack ARCHIVE (--roster FILE | --generate STUDENTS [--seed N])\n"
+            "       %s report ARCHIVE\n"
+            "       %s student ARCHIVE ID\n"
+            "  --roster    roster in the import format; student ids are roster positions\n",
+            program, program, program);
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && strcmp(argv[1], "pack") == 0) {
+        const char *rosterPath = NULL;
+        int generate = 0;
+        unsigned long long seed = 1;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            if (strcmp(argv[i], "--roster") == 0) {
+                rosterPath = argv[i + 1];
+            } else if (strcmp(argv[i], "--generate") == 0) {
+                generate = atoi(argv[i + 1]);
+            } else if (strcmp(argv[i], "--seed") == 0) {
+                seed = strtoull(argv[i + 1], NULL, 10);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        if ((rosterPath == NULL) == (generate <= 0)) {
+            usage(argv[0]);
+            return 1;
+        }
+        return pack(argv[2], rosterPath, generate, seed) ? 0 : 1;
+    }
+    if (argc == 3 && strcmp(argv[1], "report") == 0) {
+        return report(argv[2]) ? 0 : 1;
+    }
+    if (argc == 4 && strcmp(argv[1], "student") == 0) {
+        return showStudent(argv[2], (unsigned int)strtoul(argv[3], NULL, 10)) ? 0 : 1;
+    }
+    usage(argv[0]);
+    return 1;
+}
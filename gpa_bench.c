@@ -0,0 +1,796 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_archive.h"
+#include "gpa_core.h"
+#include "gpa_diff.h"
+#include "gpa_import.h"
+#include "gpa_numeric.h"
+#include "gpa_pager.h"
+#include "gpa_rank.h"
+#include "gpa_roster_gen.h"
+#include "gpa_rules.h"
+#include "gpa_search.h"
+#include "gpa_stats.h"
+#include "gpa_timer.h"
+#include "gpa_viewmodel.h"
+
+// Microbenchmarks for the grading core.
+// Results are printed as one JSON object per line for regression tracking.
+
+typedef struct {
+    RosterGenOptions options;
+    int repeat;
+    const char *only;
+    Student *students;
+    int studentCount;
+    char *rosterText;
+    size_t rosterTextLength;
+    Student *importBuffer;
+    char extra[128];    // Extra JSON fields for the current result
+
+    // Large name/GPA table for the pager benchmarks, built on first use
+    int pagerRows;
+    int nameStride;
+    char *pagerNames;
+    float *pagerGPAs;
+    Pager pager;
+    long long pagerSortNs;
+
+    // Numeric grade sheet, one line per student of the roster
+    char *sheetText;
+    size_t sheetLength;
+    long long sheetGrades;
+
+    // Standing rules and their column table, built on first use
+    RuleSet *rules;
+    RuleTable ruleTable;
+
+    // Packed archive of the roster, built on first use
+    Archive *archive;
+    ArchiveRecord *archiveRecords;
+
+    // Registrar export for the diff benchmarks: importBuffer turned into a
+    // changed copy of the roster, and a base roster for each merge
+    int diffReady;
+    Student *mergeBuffer;
+    int mergeCapacity;
+
+    // Name search index over the roster, and queries made from its names
+    SearchIndex *search;
+    char (*searchQueries)[SEARCH_MAX_QUERY];
+    long long searchBuildNs;
+} BenchContext;
+
+// Runs the workload once and returns the number of operations performed
+typedef long long (*BenchFn)(BenchContext *ctx);
+
+typedef struct {
+    const char *name;
+    BenchFn run;
+} Benchmark;
+
+// Keeps results alive so the compiler cannot drop the work
+static volatile float benchSink;
+
+static long long benchGradeConversion(BenchContext *ctx) {
+    float total = 0.0f;
+    long long ops = 0;
+
+    for (int i = 0; i < ctx->studentCount; i++) {
+        Student *student = &ctx->students[i];
+        for (int j = 0; j < student->courseCount; j++) {
+            total += letterGradeToPoints(student->courses[j].letterGrade);
+        }
+        ops += student->courseCount;
+    }
+    benchSink = total;
+    return ops;
+}
+
+static long long benchStudentGPA(BenchContext *ctx) {
+    float total = 0.0f;
+    int count = ctx->studentCount < 1000 ? ctx->studentCount : 1000;
+
+    // Same handful of students over and over: stays in cache
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < count; i++) {
+            total += computeStudentGPA(&ctx->students[i], NULL);
+        }
+    }
+    benchSink = total;
+    return 100LL * count;
+}
+
+static long long benchRosterRecompute(BenchContext *ctx) {
+    float total = 0.0f;
+
+    for (int i = 0; i < ctx->studentCount; i++) {
+        total += computeStudentGPA(&ctx->students[i], NULL);
+    }
+    benchSink = total;
+    return ctx->studentCount;
+}
+
+static long long benchFormatEntries(BenchContext *ctx) {
+    char buf[256];
+    long long ops = 0;
+    int length = 0;
+
+    for (int i = 0; i < ctx->studentCount; i++) {
+        Student *student = &ctx->students[i];
+        for (int j = 0; j < student->courseCount; j++) {
+            length += formatCourseEntry(buf, sizeof(buf), &student->courses[j]);
+        }
+        length += formatStudentEntry(buf, sizeof(buf), student);
+        length += formatStudentSummary(buf, sizeof(buf), student, totalCreditHours(student));
+        ops += student->courseCount + 2;
+    }
+    benchSink = (float)length;
+    return ops;
+}
+
+static long long benchImport(BenchContext *ctx) {
+    ImportStats stats;
+    int count = importRoster(ctx->rosterText, ctx->rosterTextLength, ctx->importBuffer,
+                             ctx->studentCount, &stats);
+    benchSink = (float)count;
+    return stats.rows;
+}
+
+// Import the whole roster and refresh the student list through the view model
+static long long runViewImport(BenchContext *ctx, int batched) {
+    ViewModel vm;
+    ViewCounters counters;
+    ImportStats stats;
+
+    memset(&counters, 0, sizeof(counters));
+    if (!viewInit(&vm, &countingViewOps, &counters, ctx->importBuffer, ctx->studentCount)) return 0;
+
+    if (batched) viewBeginBatch(&vm);
+    int count = importRoster(ctx->rosterText, ctx->rosterTextLength, ctx->importBuffer, ctx->studentCount, &stats);
+    for (int i = 0; i < count; i++) {
+        viewStudentsAdded(&vm, i, 1);
+        viewStudentChanged(&vm, i);
+    }
+    if (batched) viewEndBatch(&vm);
+
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"view_flushes\":%d,\"view_calls\":%d,\"rows_sent\":%lld",
+             counters.flushes, counters.resets + counters.replaces, counters.rowsSent);
+    viewFree(&vm);
+    return stats.rows;
+}
+
+static long long benchViewImportBatched(BenchContext *ctx) {
+    return runViewImport(ctx, 1);
+}
+
+static long long benchViewImportUnbatched(BenchContext *ctx) {
+    return runViewImport(ctx, 0);
+}
+
+// Compact row source: fixed-stride names and a GPA column
+static const char *tableName(void *context, int index) {
+    BenchContext *ctx = context;
+    return ctx->pagerNames + (size_t)index * ctx->nameStride;
+}
+
+static float tableGPA(void *context, int index) {
+    return ((BenchContext *)context)->pagerGPAs[index];
+}
+
+static int tableRow(void *context, int index, char *buf, size_t size) {
+    return snprintf(buf, size, "%s (GPA: %.2f)", tableName(context, index), tableGPA(context, index));
+}
+
+static int setupPager(BenchContext *ctx) {
+    RosterGen gen;
+    Student student;
+    PagerSource source;
+
+    if (ctx->pagerNames != NULL) return 1;
+
+    ctx->nameStride = NAME_LENGTH;
+    if (ctx->options.maxNameLength + 1 < ctx->nameStride) ctx->nameStride = ctx->options.maxNameLength + 1;
+    ctx->pagerNames = malloc((size_t)ctx->pagerRows * ctx->nameStride);
+    ctx->pagerGPAs = malloc(sizeof(float) * ctx->pagerRows);
+    if (ctx->pagerNames == NULL || ctx->pagerGPAs == NULL) return 0;
+
+    rosterGenInit(&gen, &ctx->options);
+    for (int i = 0; i < ctx->pagerRows; i++) {
+        rosterGenStudent(&gen, &student);
+        memcpy(ctx->pagerNames + (size_t)i * ctx->nameStride, student.name, ctx->nameStride - 1);
+        ctx->pagerNames[(size_t)i * ctx->nameStride + ctx->nameStride - 1] = '\0';
+        ctx->pagerGPAs[i] = student.gpa;
+    }
+
+    source.context = ctx;
+    source.count = ctx->pagerRows;
+    source.nameAt = tableName;
+    source.gpaAt = tableGPA;
+    source.formatRow = tableRow;
+
+    long long start = nowNanoseconds();
+    if (!pagerInit(&ctx->pager, &source, 20) || !pagerSetSort(&ctx->pager, PAGER_SORT_NAME)) return 0;
+    ctx->pagerSortNs = nowNanoseconds() - start;
+    return 1;
+}
+
+// Jump to random rows of a name-sorted list, formatting one page each time
+static long long benchPagerScroll(BenchContext *ctx) {
+    RosterGen gen;
+
+    if (!setupPager(ctx)) return 0;
+    rosterGenInit(&gen, &ctx->options);
+    for (int i = 0; i < 100000; i++) {
+        pagerScrollTo(&ctx->pager, (int)(rosterGenRandom(&gen) % (unsigned int)ctx->pagerRows));
+    }
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"rows\":%d,\"page\":%d,\"sort_ms\":%.1f",
+             ctx->pagerRows, ctx->pager.pageSize, ctx->pagerSortNs / 1e6);
+    return 100000;
+}
+
+// Binary-search seek by name prefix, then show that page
+static long long benchPagerSeek(BenchContext *ctx) {
+    RosterGen gen;
+
+    if (!setupPager(ctx)) return 0;
+    rosterGenInit(&gen, &ctx->options);
+    for (int i = 0; i < 100000; i++) {
+        const char *target = tableName(ctx, (int)(rosterGenRandom(&gen) % (unsigned int)ctx->pagerRows));
+        char prefix[4];
+        memcpy(prefix, target, 3);
+        prefix[3] = '\0';
+        pagerScrollTo(&ctx->pager, pagerSeekName(&ctx->pager, prefix));
+    }
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"rows\":%d,\"page\":%d", ctx->pagerRows, ctx->pager.pageSize);
+    return 100000;
+}
+
+// Percentages derived from the roster's letter grades, "Name,87.5,92.0,..."
+static int setupSheet(BenchContext *ctx) {
+    size_t capacity = (size_t)ctx->studentCount * (NAME_LENGTH + MAX_COURSES * 8) + 1;
+
+    if (ctx->sheetText != NULL) return 1;
+    ctx->sheetText = malloc(capacity);
+    if (ctx->sheetText == NULL) return 0;
+
+    char *p = ctx->sheetText;
+    for (int i = 0; i < ctx->studentCount; i++) {
+        Student *student = &ctx->students[i];
+        p += sprintf(p, "%s", student->name);
+        for (int j = 0; j < student->courseCount; j++) {
+            int tenths = 550 + (int)(letterGradeToPoints(student->courses[j].letterGrade) * 100) + (i + j) % 10;
+            p += sprintf(p, ",%d.%d", tenths / 10, tenths % 10);
+        }
+        *p++ = '\n';
+        ctx->sheetGrades += student->courseCount;
+    }
+    *p = '\0';
+    ctx->sheetLength = (size_t)(p - ctx->sheetText);
+    return 1;
+}
+
+static long long benchNumericParse(BenchContext *ctx) {
+    const char *p;
+    float total = 0.0f;
+    long long ops = 0;
+
+    if (!setupSheet(ctx)) return 0;
+    for (p = ctx->sheetText; *p != '\0'; p++) {
+        if (*p == ',') {
+            float grade;
+            parseGrade(p + 1, &p, &grade);
+            total += grade;
+            ops++;
+            p--;
+        }
+    }
+    benchSink = total;
+    return ops;
+}
+
+// Same scan with the C library parser, as a baseline
+static long long benchNumericStrtod(BenchContext *ctx) {
+    const char *p;
+    float total = 0.0f;
+    long long ops = 0;
+
+    if (!setupSheet(ctx)) return 0;
+    for (p = ctx->sheetText; *p != '\0'; p++) {
+        if (*p == ',') {
+            char *end;
+            total += (float)strtod(p + 1, &end);
+            p = end - 1;
+            ops++;
+        }
+    }
+    benchSink = total;
+    return ops;
+}
+
+static long long benchNumericBatch(BenchContext *ctx) {
+    NumericOptions options;
+    NumericStats stats;
+
+    if (!setupSheet(ctx)) return 0;
+    numericDefaults(&options);
+    numericBatch(ctx->sheetText, ctx->sheetLength, &options, NULL, NULL, &stats);
+    benchSink = (float)stats.grades;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"grades\":%lld,\"bytes\":%zu", stats.grades, ctx->sheetLength);
+    return stats.rows;
+}
+
+// Two dozen rules: the defaults plus threshold sweeps over every operand kind
+static int setupRules(BenchContext *ctx) {
+    static const char *const prefixes[] = {"CS", "MATH", "PHYS", "HIST"};
+    char text[4096];
+    int length;
+
+    if (ctx->rules != NULL) return 1;
+    ctx->rules = malloc(sizeof(RuleSet));
+    if (ctx->rules == NULL) return 0;
+
+    length = snprintf(text, sizeof(text), "%s", defaultStandingRules);
+    for (int i = 0; i < 7; i++) {
+        length += snprintf(text + length, sizeof(text) - length, "gpa_band_%d: gpa >= %d.%d and gpa < %d.%d\n",
+                           i, i / 2, (i % 2) * 5, (i + 1) / 2, ((i + 1) % 2) * 5);
+    }
+    for (int i = 0; i < 4; i++) {
+        length += snprintf(text + length, sizeof(text) - length,
+                           "major_ok_%d: min_grade(\"%s\") >= C and credits >= %d\n"
+                           "major_star_%d: max_grade(\"%s\") >= A or (courses > 6 and not (gpa < 3.0))\n",
+                           i, prefixes[i], 8 + i * 2, i, prefixes[i]);
+    }
+    length += snprintf(text + length, sizeof(text) - length, "overload: credits > 24 or courses >= 8\n"
+                       "underload: credits < 12\n"
+                       "clean: min_grade(\"\") >= B- and not (courses < 4)\n"
+                       "mixed: (gpa >= 3.0 and min_grade(\"\") < C) or (gpa < 2.5 and max_grade(\"\") == A+)\n"
+                       "no_math: max_grade(\"MATH\") < 0\n"
+                       "full_time: credits >= 12 and credits <= 18\n");
+    if (!rulesCompile(ctx->rules, text)) {
+        fprintf(stderr, "Benchmark rules: %s\n", ctx->rules->error);
+        return 0;
+    }
+    return rulesExtract(ctx->rules, ctx->students, ctx->studentCount, &ctx->ruleTable);
+}
+
+// Per student: one pass gathering every column the rules read
+static long long benchRulesExtract(BenchContext *ctx) {
+    RuleTable table;
+
+    if (!setupRules(ctx) || !rulesExtract(ctx->rules, ctx->students, ctx->studentCount, &table)) return 0;
+    benchSink = table.columns[0][0];
+    rulesFreeTable(&table);
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"rules\":%d,\"columns\":%d",
+             ctx->rules->ruleCount, ctx->rules->columnCount);
+    return ctx->studentCount;
+}
+
+// Per student: every rule over the extracted table
+static long long benchRulesEvaluate(BenchContext *ctx) {
+    RuleResults results;
+    long long flagged = 0;
+
+    if (!setupRules(ctx) || !rulesEvaluate(ctx->rules, &ctx->ruleTable, &results)) return 0;
+    for (int r = 0; r < ctx->rules->ruleCount; r++) flagged += results.counts[r];
+    rulesFreeResults(&results);
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"rules\":%d,\"flags\":%lld", ctx->rules->ruleCount, flagged);
+    return ctx->studentCount;
+}
+
+// Per course record: intern the name and pack it, block flushes included
+static long long benchArchiveEncode(BenchContext *ctx) {
+    Archive archive;
+
+    if (!archiveInit(&archive)) return 0;
+    for (int i = 0; i < ctx->studentCount; i++) {
+        archiveAddStudent(&archive, (unsigned int)i, &ctx->students[i]);
+    }
+    archiveFinish(&archive);
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"bytes\":%zu,\"bytes_per_record\":%.2f",
+             archive.length, archive.recordCount > 0 ? (double)archive.length / archive.recordCount : 0.0);
+    long long records = archive.recordCount;
+    archiveFree(&archive);
+    return records;
+}
+
+static int setupArchive(BenchContext *ctx) {
+    if (ctx->archive != NULL) return 1;
+    ctx->archive = malloc(sizeof(Archive));
+    ctx->archiveRecords = malloc(sizeof(ArchiveRecord) * ARCHIVE_BLOCK_RECORDS);
+    if (ctx->archive == NULL || ctx->archiveRecords == NULL || !archiveInit(ctx->archive)) return 0;
+    for (int i = 0; i < ctx->studentCount; i++) {
+        archiveAddStudent(ctx->archive, (unsigned int)i, &ctx->students[i]);
+    }
+    return archiveFinish(ctx->archive);
+}
+
+// Per course record: decode every block of the archive
+static long long benchArchiveDecode(BenchContext *ctx) {
+    long long records = 0;
+    unsigned int check = 0;
+
+    if (!setupArchive(ctx)) return 0;
+    for (int b = 0; b < ctx->archive->blockCount; b++) {
+        int count = archiveDecodeBlock(ctx->archive, b, ctx->archiveRecords);
+        check += ctx->archiveRecords[count - 1].courseId;
+        records += count;
+    }
+    benchSink = (float)check;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"bytes\":%zu,\"course_bytes\":%lld", ctx->archive->length,
+             records * (long long)sizeof(Course));
+    return records;
+}
+
+static int countRank(void *context, long long rank, const RankEntry *entry) {
+    (void)entry;
+    *(long long *)context += rank;
+    return 1;
+}
+
+// Per student: collect, sort and stream the ranking under a memory budget
+static long long runRanking(BenchContext *ctx, size_t budget) {
+    RankOptions options;
+    RankSorter sorter;
+    long long rankSum = 0;
+
+    rankDefaults(&options);
+    options.memoryBudget = budget;
+    if (!rankInit(&sorter, &options)) return 0;
+    for (int i = 0; i < ctx->studentCount; i++) {
+        rankAddStudent(&sorter, (unsigned int)i, &ctx->students[i]);
+    }
+    if (!rankFinish(&sorter, countRank, &rankSum)) {
+        rankFree(&sorter);
+        return 0;
+    }
+    benchSink = (float)rankSum;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"budget_mb\":%.1f,\"data_mb\":%.1f,\"runs\":%d,\"merge_passes\":%d",
+             sorter.options.memoryBudget / 1048576.0, ctx->studentCount * (double)sizeof(RankEntry) / 1048576.0,
+             sorter.spilledRuns, sorter.mergePasses);
+    rankFree(&sorter);
+    return ctx->studentCount;
+}
+
+static long long benchRankInMemory(BenchContext *ctx) {
+    return runRanking(ctx, (size_t)ctx->studentCount * (sizeof(RankEntry) + 64) + RANK_MIN_MEMORY);
+}
+
+// Budget of a quarter of the data, so the ranking spills several runs
+static long long benchRankExternal(BenchContext *ctx) {
+    return runRanking(ctx, (size_t)ctx->studentCount * sizeof(RankEntry) / 4);
+}
+
+// The import benchmarks run first and are done with importBuffer by now
+static int setupDiff(BenchContext *ctx) {
+    if (ctx->diffReady) return 1;
+    ctx->mergeCapacity = ctx->studentCount + ctx->studentCount / 100 + 1;
+    ctx->mergeBuffer = malloc(sizeof(Student) * ctx->mergeCapacity);
+    if (ctx->mergeBuffer == NULL) return 0;
+
+    // 5% regraded, 2% with a new course, 0.5% replaced by a new student
+    memcpy(ctx->importBuffer, ctx->students, sizeof(Student) * ctx->studentCount);
+    for (int i = 0; i < ctx->studentCount; i++) {
+        Student *student = &ctx->importBuffer[i];
+        if (i % 20 == 0 && student->courseCount > 0) {
+            Course *course = &student->courses[0];
+            strcpy(course->letterGrade, strcmp(course->letterGrade, "A") == 0 ? "B" : "A");
+        }
+        if (i % 50 == 0 && student->courseCount < MAX_COURSES) {
+            Course *course = &student->courses[student->courseCount++];
+            strcpy(course->name, "SEM 900");
+            course->creditHours = 1;
+            strcpy(course->letterGrade, "B");
+        }
+        if (i % 200 == 0) snprintf(student->name, sizeof(student->name), "Transfer %d", i);
+    }
+    ctx->diffReady = 1;
+    return 1;
+}
+
+static void countChange(void *context, const RosterChange *change) {
+    (void)change;
+    (*(long long *)context)++;
+}
+
+// Per student of both rosters: sort, join and stream the changes
+static long long benchRosterDiff(BenchContext *ctx) {
+    DiffSummary summary;
+    long long changes = 0;
+
+    if (!setupDiff(ctx)) return 0;
+    if (!rosterDiff(ctx->students, ctx->studentCount, ctx->importBuffer, ctx->studentCount, countChange, &changes,
+                    &summary)) {
+        return 0;
+    }
+    benchSink = (float)changes;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"changes\":%lld,\"students_changed\":%d", changes,
+             summary.studentsChanged);
+    return 2LL * ctx->studentCount;
+}
+
+// Same, then the batch apply; the base roster is restored from a copy
+// first, which is timed separately and reported
+static long long benchRosterMerge(BenchContext *ctx) {
+    int count = ctx->studentCount;
+
+    if (!setupDiff(ctx)) return 0;
+    long long start = nowNanoseconds();
+    memcpy(ctx->mergeBuffer, ctx->students, sizeof(Student) * count);
+    long long copied = nowNanoseconds();
+    if (!rosterMerge(ctx->mergeBuffer, &count, ctx->mergeCapacity, ctx->importBuffer, ctx->studentCount, NULL, NULL,
+                     NULL)) {
+        return 0;
+    }
+    benchSink = ctx->mergeBuffer[count - 1].gpa;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"copy_ms\":%.1f", (copied - start) / 1e6);
+    return 2LL * ctx->studentCount;
+}
+
+#define SEARCH_QUERIES 1000
+
+// Every student and course name indexed one add at a time, as the
+// calculator does; queries are a name with a typo, its first letters or a
+// piece of it, in turn
+static int setupSearch(BenchContext *ctx) {
+    if (ctx->search != NULL) return 1;
+    ctx->search = malloc(sizeof(SearchIndex));
+    ctx->searchQueries = malloc(sizeof(*ctx->searchQueries) * SEARCH_QUERIES);
+    if (ctx->search == NULL || ctx->searchQueries == NULL || !searchInit(ctx->search)) return 0;
+
+    long long start = nowNanoseconds();
+    for (int i = 0; i < ctx->studentCount; i++) {
+        if (!searchAddStudent(ctx->search, i, ctx->students[i].name)) return 0;
+        for (int j = 0; j < ctx->students[i].courseCount; j++) {
+            if (!searchAddCourse(ctx->search, ctx->students[i].courses[j].name)) return 0;
+        }
+    }
+    ctx->searchBuildNs = nowNanoseconds() - start;
+
+    for (int q = 0; q < SEARCH_QUERIES; q++) {
+        char *query = ctx->searchQueries[q];
+        snprintf(query, SEARCH_MAX_QUERY, "%.*s", SEARCH_MAX_QUERY - 1,
+                 ctx->students[(q * 7919LL) % ctx->studentCount].name);
+        int length = (int)strlen(query);
+        if (length < 4) continue;
+        if (q % 3 == 0) {
+            query[q % length] = 'x';
+        } else if (q % 3 == 1) {
+            query[2 + q % 4] = '\0';
+        } else {
+            int first = q % (length - 3);
+            memmove(query, query + first, length - first + 1);
+            query[3 + q % 5] = '\0';
+        }
+    }
+    return 1;
+}
+
+// Per query: ScanCount over the query's trigrams, then verify the best
+// candidates until the top ten are settled
+static long long benchSearchQuery(BenchContext *ctx) {
+    SearchHit hits[10];
+    long long found = 0;
+
+    if (!setupSearch(ctx)) return 0;
+    for (int q = 0; q < SEARCH_QUERIES; q++) {
+        found += searchQuery(ctx->search, ctx->searchQueries[q], hits, 10);
+    }
+    benchSink = (float)found;
+    snprintf(ctx->extra, sizeof(ctx->extra), ",\"entries\":%d,\"build_ms\":%.1f,\"hits\":%lld",
+             ctx->search->entryCount, ctx->searchBuildNs / 1e6, found);
+    return SEARCH_QUERIES;
+}
+
+// Histogram update alone, with a spread of latencies
+static long long benchStatsRecord(BenchContext *ctx) {
+    (void)ctx;
+    for (unsigned long long i = 0; i < 1000000; i++) {
+        statsRecord(STAT_CALCULATE_GPA, (i * 2654435761ULL) & 0xFFFF);
+    }
+    return 1000000;
+}
+
+// What STATS_BEGIN/STATS_END cost per event, sampling included
+static long long benchStatsEvent(BenchContext *ctx) {
+    (void)ctx;
+    for (int i = 0; i < 1000000; i++) {
+        unsigned long long start = statsBegin(STAT_CALCULATE_GPA);
+        statsEnd(STAT_CALCULATE_GPA, start);
+    }
+    return 1000000;
+}
+
+static const Benchmark benchmarks[] = {
+    {"grade_conversion", benchGradeConversion},
+    {"student_gpa", benchStudentGPA},
+    {"roster_recompute", benchRosterRecompute},
+    {"format_entries", benchFormatEntries},
+    {"import", benchImport},
+    {"view_import_batched", benchViewImportBatched},
+    {"view_import_unbatched", benchViewImportUnbatched},
+    {"pager_scroll", benchPagerScroll},
+    {"pager_seek", benchPagerSeek},
+    {"numeric_parse", benchNumericParse},
+    {"numeric_strtod", benchNumericStrtod},
+    {"numeric_batch", benchNumericBatch},
+    {"rules_extract", benchRulesExtract},
+    {"rules_evaluate", benchRulesEvaluate},
+    {"archive_encode", benchArchiveEncode},
+    {"archive_decode", benchArchiveDecode},
+    {"rank_in_memory", benchRankInMemory},
+    {"rank_external", benchRankExternal},
+    {"roster_diff", benchRosterDiff},
+    {"roster_merge", benchRosterMerge},
+    {"search_query", benchSearchQuery},
+    {"stats_record", benchStatsRecord},
+    {"stats_event", benchStatsEvent},
+};
+
+static int compareLongLong(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Returns 0 if the benchmark did no work, which means its setup failed;
+// printing 0 ns/op for it would look infinitely fast
+static int runBenchmark(BenchContext *ctx, const Benchmark *bench) {
+    long long *times = malloc(sizeof(long long) * ctx->repeat);
+    long long ops = 0;
+
+    if (times == NULL) {
+        fprintf(stderr, "Out of memory for %s timings.\n", bench->name);
+        return 0;
+    }
+
+    // Warm-up pass
+    ctx->extra[0] = '\0';
+    ops = bench->run(ctx);
+
+    for (int r = 0; r < ctx->repeat && ops > 0; r++) {
+        long long start = nowNanoseconds();
+        ops = bench->run(ctx);
+        times[r] = nowNanoseconds() - start;
+    }
+    if (ops <= 0) {
+        fprintf(stderr, "Benchmark %s failed: setup ran out of memory or did no work.\n", bench->name);
+        free(times);
+        return 0;
+    }
+    qsort(times, ctx->repeat, sizeof(long long), compareLongLong);
+
+    double best = ops > 0 ? (double)times[0] / ops : 0.0;
+    double median = ops > 0 ? (double)times[ctx->repeat / 2] / ops : 0.0;
+    printf("{\"bench\":\"%s\",\"students\":%d,\"seed\":%llu,\"repeat\":%d,\"ops\":%lld,"
+           "\"best_ns_per_op\":%.3f,\"median_ns_per_op\":%.3f,\"ops_per_sec\":%.0f%s}\n",
+           bench->name, ctx->studentCount, ctx->options.seed, ctx->repeat, ops,
+           best, median, best > 0.0 ? 1e9 / best : 0.0, ctx->extra);
+    fflush(stdout);
+    free(times);
+    return 1;
+}
+
+static int parseRange(const char *arg, int *low, int *high) {
+    if (sscanf(arg, "%d-%d", low, high) == 2) return *low <= *high;
+    if (sscanf(arg, "%d", low) == 1) {
+        *high = *low;
+        return 1;
+    }
+    return 0;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --students N          roster size (default 10000)\n"
+            "  --courses MIN-MAX     courses per student (default 4-8, max %d)\n"
+            "  --credits MIN-MAX     credit hours per course (default 1-4)\n"
+            "  --name-length MIN-MAX student name length (default 8-20)\n"
+            "  --grades SPEC         uniform, typical, struggling or 13 weights A+..F\n"
+            "  --seed N              generator seed (default 1)\n"
+            "  --repeat N            timed runs per benchmark (default 5)\n"
+            "  --pager-rows N        rows in the pager benchmarks (default 1000000)\n"
+            "  --only NAME           run a single benchmark\n",
+            program, MAX_COURSES);
+}
+
+int main(int argc, char **argv) {
+    BenchContext ctx;
+    RosterGen gen;
+    int matched = 0, failed = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    rosterGenDefaults(&ctx.options);
+    ctx.repeat = 5;
+    ctx.pagerRows = 1000000;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int ok = value != NULL;
+
+        if (strcmp(arg, "--students") == 0 && ok) {
+            ctx.options.studentCount = atoi(value);
+            ok = ctx.options.studentCount > 0;
+        } else if (strcmp(arg, "--courses") == 0 && ok) {
+            ok = parseRange(value, &ctx.options.minCourses, &ctx.options.maxCourses);
+        } else if (strcmp(arg, "--credits") == 0 && ok) {
+            ok = parseRange(value, &ctx.options.minCredits, &ctx.options.maxCredits);
+        } else if (strcmp(arg, "--name-length") == 0 && ok) {
+            ok = parseRange(value, &ctx.options.minNameLength, &ctx.options.maxNameLength);
+        } else if (strcmp(arg, "--grades") == 0 && ok) {
+            ok = rosterGenParseGrades(value, ctx.options.gradeWeights);
+        } else if (strcmp(arg, "--seed") == 0 && ok) {
+            ctx.options.seed = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--repeat") == 0 && ok) {
+            ctx.repeat = atoi(value);
+            ok = ctx.repeat > 0;
+        } else if (strcmp(arg, "--pager-rows") == 0 && ok) {
+            ctx.pagerRows = atoi(value);
+            ok = ctx.pagerRows > 0;
+        } else if (strcmp(arg, "--only") == 0 && ok) {
+            ctx.only = value;
+        } else {
+            ok = 0;
+        }
+
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    // Build the roster and its import text once, outside the timed region
+    ctx.studentCount = ctx.options.studentCount;
+    ctx.students = malloc(sizeof(Student) * ctx.studentCount);
+    ctx.importBuffer = malloc(sizeof(Student) * ctx.studentCount);
+    if (ctx.students == NULL || ctx.importBuffer == NULL) {
+        fprintf(stderr, "Out of memory for %d students.\n", ctx.studentCount);
+        return 1;
+    }
+    rosterGenInit(&gen, &ctx.options);
+    rosterGenFill(&gen, ctx.students, ctx.studentCount);
+    ctx.rosterText = exportRoster(ctx.students, ctx.studentCount, &ctx.rosterTextLength);
+    if (ctx.rosterText == NULL) {
+        fprintf(stderr, "Out of memory for roster text.\n");
+        return 1;
+    }
+
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++) {
+        if (ctx.only != NULL && strcmp(ctx.only, benchmarks[b].name) != 0) continue;
+        matched++;
+        if (!runBenchmark(&ctx, &benchmarks[b])) {
+            failed = 1;
+            break;
+        }
+    }
+
+    if (matched == 0) {
+        fprintf(stderr, "Unknown benchmark: %s\n", ctx.only);
+    }
+
+    // Keep the overhead runs out of any scraped numbers
+    statsReset();
+
+    if (ctx.pagerNames != NULL) pagerFree(&ctx.pager);
+    free(ctx.pagerNames);
+    free(ctx.pagerGPAs);
+    free(ctx.sheetText);
+    if (ctx.rules != NULL) rulesFreeTable(&ctx.ruleTable);
+    free(ctx.rules);
+    if (ctx.archive != NULL) archiveFree(ctx.archive);
+    free(ctx.archive);
+    free(ctx.archiveRecords);
+    free(ctx.mergeBuffer);
+    if (ctx.search != NULL) searchFree(ctx.search);
+    free(ctx.search);
+    free(ctx.searchQueries);
+    free(ctx.rosterText);
+    free(ctx.importBuffer);
+    free(ctx.students);
+    return matched > 0 && !failed ? 0 : 1;
+}
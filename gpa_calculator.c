@@ -1,6 +1,7 @@
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "gpa_numeric.h"
 
 #define MAX_STUDENTS 100
 #define MAX_SUBJECTS 10
@@ -54,15 +55,14 @@ void calculateGPA(HWND hwnd) {
     strncpy(new_student->name, name, sizeof(new_student->name));
     new_student->subject_count = subject_count;
 
-    float sum = 0;
     for (int i = 0; i < subject_count; i++) {
         GetWindowText(hGradeEdits[i], buf, 32);
-        float grade = atof(buf);
+        float grade = 0;
+        parseGrade(buf, NULL, &grade);
         new_student->grades[i] = grade;
-        sum += grade;
     }
 
-    float gpa = sum / subject_count;
+    float gpa = averageGrades(new_student->grades, subject_count);
 
     char result[512];
     snprintf(result, sizeof(result), "Student: %s\r\nGPA: %.2f\r\n", name, gpa);
@@ -2,32 +2,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-// Constants
-#define MAX_STUDENTS 10
-#define MAX_COURSES 20
-#define NAME_LENGTH 100
-
-// Structure for a course
-typedef struct {
-    char name[NAME_LENGTH];
-    char letterGrade[3];  // A+, B-, etc.
-    int creditHours;
-    float gradePoints;    // Calculated from letter grade
-} Course;
-
-// Structure for a student
-typedef struct {
-    char name[NAME_LENGTH];
-    Course courses[MAX_COURSES];
-    int courseCount;
-    float gpa;
-} Student;
+#include "gpa_controller.h"
+#include "gpa_replay.h"
+#include "gpa_stats.h"
+#include "gpa_viewmodel.h"
 
 // Global variables
 Student students[MAX_STUDENTS];
-int studentCount = 0;
-int currentStudent = 0;
 
 // UI handles
 HWND hMainWindow;
@@ -35,177 +16,116 @@ HWND hStudentNameEdit, hStudentList;
 HWND hCourseNameEdit, hCreditEdit, hGradeCombo;
 HWND hCoursesListBox, hOutputEdit;
 HWND hAddCourseBtn, hCalcGPABtn, hNewStudentBtn, hClearBtn, hSwitchStudentBtn;
+HWND hFindEdit, hFindBtn;
+
+// Listbox and output updates go through the view model
+ViewModel viewModel;
+
+// What the buttons do; this file only reads and writes the controls
+Controller controller;
+
+// Session recording for gpa_replay (set GPA_RECORD=<file> to enable)
+FILE *recordFile = NULL;
 
 // Function prototypes
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
-float letterGradeToPoints(const char *grade);
-void calculateGPA(int studentIndex);
-void addCourse();
-void clearCurrentForm();
-void displayStudentData(int index);
-void switchStudent();
+void readForm(ControllerForm *form);
+void runCommand(int commandId);
+void listBeginUpdate(void *context);
+void listEndUpdate(void *context);
+void listResetRows(void *context, ViewList list, const char (*rows)[LIST_ROW_LENGTH], int count);
+void listReplaceRows(void *context, ViewList list, int first, const char (*rows)[LIST_ROW_LENGTH], int count);
+void listSetSelection(void *context, ViewList list, int index);
+void outputSetText(void *context, const char *text);
 
-// Convert letter grade to grade points
-float letterGradeToPoints(const char *grade) {
-    char letter = grade[0];
-    char modifier = grade[1];
-    float points = 0.0f;
-    
-    // Base points for letter grade
-    switch (letter) {
-        case 'A': points = 4.0f; break;
-        case 'B': points = 3.0f; break;
-        case 'C': points = 2.0f; break;
-        case 'D': points = 1.0f; break;
-        case 'F': points = 0.0f; break;
-        default: return 0.0f;
-    }
-    
-    // Adjust for + or - (except A+ remains 4.0)
-    if (modifier == '+' && letter != 'A') {
-        points += 0.3f;
-    } else if (modifier == '-') {
-        points -= 0.3f;
-    }
-    
-    return points;
+const ViewOps listViewOps = {
+    listBeginUpdate, listEndUpdate, listResetRows, listReplaceRows, listSetSelection, outputSetText
+};
+
+// Listbox behind a view-model list
+HWND listHandle(ViewList list) {
+    return list == VIEW_STUDENT_LIST ? hStudentList : hCoursesListBox;
 }
 
-// Calculate GPA for a student
-void calculateGPA(int studentIndex) {
-    if (studentIndex < 0 || studentIndex >= studentCount) return;
-    
-    Student *student = &students[studentIndex];
-    float totalPoints = 0.0f;
-    int totalCredits = 0;
-    
-    for (int i = 0; i < student->courseCount; i++) {
-        Course *course = &student->courses[i];
-        course->gradePoints = letterGradeToPoints(course->letterGrade);
-        totalPoints += course->gradePoints * course->creditHours;
-        totalCredits += course->creditHours;
-    }
-    
-    if (totalCredits > 0) {
-        student->gpa = totalPoints / totalCredits;
-    } else {
-        student->gpa = 0.0f;
-    }
-    
-    // Display calculated GPA
-    char result[256];
-    sprintf(result, "Student: %s\r\nTotal Credits: %d\r\nGPA: %.2f", 
-            student->name, totalCredits, student->gpa);
-    SetWindowText(hOutputEdit, result);
-    
-    // Update the student list
-    SendMessage(hStudentList, LB_DELETESTRING, studentIndex, 0);
-    sprintf(result, "%s (GPA: %.2f)", student->name, student->gpa);
-    SendMessage(hStudentList, LB_INSERTSTRING, studentIndex, (LPARAM)result);
-    SendMessage(hStudentList, LB_SETCURSEL, studentIndex, 0);
+// Suspend redraw while the view model pushes a batch
+void listBeginUpdate(void *context) {
+    (void)context;
+    SendMessage(hStudentList, WM_SETREDRAW, FALSE, 0);
+    SendMessage(hCoursesListBox, WM_SETREDRAW, FALSE, 0);
 }
 
-// Add a course to the current student
-void addCourse() {
-    if (currentStudent < 0 || currentStudent >= studentCount) return;
-    
-    Student *student = &students[currentStudent];
-    
-    if (student->courseCount >= MAX_COURSES) {
-        MessageBox(hMainWindow, "Maximum number of courses reached.", "Warning", MB_OK | MB_ICONWARNING);
-        return;
-    }
-    
-    Course *course = &student->courses[student->courseCount];
-    
-    // Get course name
-    GetWindowText(hCourseNameEdit, course->name, NAME_LENGTH);
-    if (strlen(course->name) == 0) {
-        MessageBox(hMainWindow, "Please enter a course name.", "Error", MB_OK | MB_ICONERROR);
-        return;
-    }
-    
-    // Get credit hours
-    char creditStr[10];
-    GetWindowText(hCreditEdit, creditStr, 10);
-    course->creditHours = atoi(creditStr);
-    if (course->creditHours <= 0) {
-        MessageBox(hMainWindow, "Please enter valid credit hours.", "Error", MB_OK | MB_ICONERROR);
-        return;
-    }
-    
-    // Get letter grade
-    int selectedGrade = SendMessage(hGradeCombo, CB_GETCURSEL, 0, 0);
-    if (selectedGrade == CB_ERR) {
-        MessageBox(hMainWindow, "Please select a grade.", "Error", MB_OK | MB_ICONERROR);
-        return;
+void listEndUpdate(void *context) {
+    (void)context;
+    SendMessage(hStudentList, WM_SETREDRAW, TRUE, 0);
+    SendMessage(hCoursesListBox, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(hStudentList, NULL, TRUE);
+    InvalidateRect(hCoursesListBox, NULL, TRUE);
+}
+
+void listResetRows(void *context, ViewList list, const char (*rows)[LIST_ROW_LENGTH], int count) {
+    HWND hList = listHandle(list);
+    (void)context;
+    SendMessage(hList, LB_RESETCONTENT, 0, 0);
+    for (int i = 0; i < count; i++) {
+        SendMessage(hList, LB_ADDSTRING, 0, (LPARAM)rows[i]);
     }
-    SendMessage(hGradeCombo, CB_GETLBTEXT, selectedGrade, (LPARAM)course->letterGrade);
-    
-    // Add course to list
-    char listEntry[256];
-    sprintf(listEntry, "%s - %d credits - %s", course->name, course->creditHours, course->letterGrade);
-    SendMessage(hCoursesListBox, LB_ADDSTRING, 0, (LPARAM)listEntry);
-    
-    student->courseCount++;
-    
-    // Clear input fields for next course
-    SetWindowText(hCourseNameEdit, "");
-    SetWindowText(hCreditEdit, "");
-    SendMessage(hGradeCombo, CB_SETCURSEL, 0, 0);
 }
 
-// Clear the current form
-void clearCurrentForm() {
-    SetWindowText(hCourseNameEdit, "");
-    SetWindowText(hCreditEdit, "");
-    SendMessage(hGradeCombo, CB_SETCURSEL, 0, 0);
-    SendMessage(hCoursesListBox, LB_RESETCONTENT, 0, 0);
-    SetWindowText(hOutputEdit, "");
-    
-    if (currentStudent >= 0 && currentStudent < studentCount) {
-        students[currentStudent].courseCount = 0;
+void listReplaceRows(void *context, ViewList list, int first, const char (*rows)[LIST_ROW_LENGTH], int count) {
+    HWND hList = listHandle(list);
+    int existing = SendMessage(hList, LB_GETCOUNT, 0, 0);
+    (void)context;
+    for (int i = 0; i < count; i++) {
+        if (first + i < existing) {
+            SendMessage(hList, LB_DELETESTRING, first + i, 0);
+            SendMessage(hList, LB_INSERTSTRING, first + i, (LPARAM)rows[i]);
+        } else {
+            SendMessage(hList, LB_ADDSTRING, 0, (LPARAM)rows[i]);
+        }
     }
 }
 
-// Display student data in the form
-void displayStudentData(int index) {
-    if (index < 0 || index >= studentCount) return;
-    
-    currentStudent = index;
-    Student *student = &students[index];
+void listSetSelection(void *context, ViewList list, int index) {
+    (void)context;
+    SendMessage(listHandle(list), LB_SETCURSEL, index, 0);
+}
+
+void outputSetText(void *context, const char *text) {
+    (void)context;
+    SetWindowText(hOutputEdit, text);
+}
+
+// Read the controls a command may look at
+void readForm(ControllerForm *form) {
+    GetWindowText(hStudentNameEdit, form->studentName, NAME_LENGTH);
+    GetWindowText(hCourseNameEdit, form->courseName, NAME_LENGTH);
+    GetWindowText(hCreditEdit, form->credits, sizeof(form->credits));
+    GetWindowText(hFindEdit, form->find, SEARCH_MAX_QUERY);
+    form->grade = SendMessage(hGradeCombo, CB_GETCURSEL, 0, 0);
+    form->selection = SendMessage(hStudentList, LB_GETCURSEL, 0, 0);
+}
+
+// Record and run one command, then apply its reply to the controls
+void runCommand(int commandId) {
+    ControllerForm form;
+    ControllerReply reply;
     
-    // Clear current display
-    SendMessage(hCoursesListBox, LB_RESETCONTENT, 0, 0);
+    readForm(&form);
+    if (recordFile != NULL) recordFormCommand(recordFile, commandId, &form);
+    controllerCommand(&controller, commandId, &form, &reply);
     
-    // Display student courses
-    for (int i = 0; i < student->courseCount; i++) {
-        Course *course = &student->courses[i];
-        char listEntry[256];
-        sprintf(listEntry, "%s - %d credits - %s", course->name, course->creditHours, course->letterGrade);
-        SendMessage(hCoursesListBox, LB_ADDSTRING, 0, (LPARAM)listEntry);
+    if (reply.clearCourseForm) {
+        SetWindowText(hCourseNameEdit, "");
+        SetWindowText(hCreditEdit, "");
+        SendMessage(hGradeCombo, CB_SETCURSEL, 0, 0);
     }
-    
-    // Display GPA if calculated
-    if (student->gpa > 0) {
-        char result[256];
-        int totalCredits = 0;
-        for (int i = 0; i < student->courseCount; i++) {
-            totalCredits += student->courses[i].creditHours;
-        }
-        sprintf(result, "Student: %s\r\nTotal Credits: %d\r\nGPA: %.2f", 
-                student->name, totalCredits, student->gpa);
-        SetWindowText(hOutputEdit, result);
-    } else {
-        SetWindowText(hOutputEdit, "");
+    if (reply.clearStudentName) {
+        SetWindowText(hStudentNameEdit, "");
     }
-}
-
-// Switch to selected student
-void switchStudent() {
-    int selectedIndex = SendMessage(hStudentList, LB_GETCURSEL, 0, 0);
-    if (selectedIndex != LB_ERR) {
-        displayStudentData(selectedIndex);
+    if (reply.severity == CONTROLLER_WARNING) {
+        MessageBox(hMainWindow, reply.message, "Warning", MB_OK | MB_ICONWARNING);
+    } else if (reply.severity == CONTROLLER_ERROR) {
+        MessageBox(hMainWindow, reply.message, "Error", MB_OK | MB_ICONERROR);
     }
 }
 
@@ -219,7 +139,7 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             hStudentNameEdit = CreateWindow("EDIT", "", WS_VISIBLE | WS_CHILD | WS_BORDER,
                                           130, 20, 150, 20, hwnd, NULL, NULL, NULL);
             hNewStudentBtn = CreateWindow("BUTTON", "Add Student", WS_VISIBLE | WS_CHILD,
-                                         290, 20, 100, 20, hwnd, (HMENU)1, NULL, NULL);
+                                         290, 20, 100, 20, hwnd, (HMENU)CMD_ADD_STUDENT, NULL, NULL);
             
             // Student list
             CreateWindow("STATIC", "Students:", WS_VISIBLE | WS_CHILD,
@@ -227,7 +147,15 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             hStudentList = CreateWindow("LISTBOX", "", WS_VISIBLE | WS_CHILD | WS_BORDER | LBS_NOTIFY,
                                        400, 40, 180, 100, hwnd, NULL, NULL, NULL);
             hSwitchStudentBtn = CreateWindow("BUTTON", "Switch Student", WS_VISIBLE | WS_CHILD,
-                                           400, 150, 180, 20, hwnd, (HMENU)5, NULL, NULL);
+                                           400, 150, 180, 20, hwnd, (HMENU)CMD_SWITCH_STUDENT, NULL, NULL);
+            
+            // Name search
+            CreateWindow("STATIC", "Find:", WS_VISIBLE | WS_CHILD,
+                         400, 180, 40, 20, hwnd, NULL, NULL, NULL);
+            hFindEdit = CreateWindow("EDIT", "", WS_VISIBLE | WS_CHILD | WS_BORDER,
+                                   440, 180, 90, 20, hwnd, NULL, NULL, NULL);
+            hFindBtn = CreateWindow("BUTTON", "Find", WS_VISIBLE | WS_CHILD,
+                                  535, 180, 45, 20, hwnd, (HMENU)CMD_FIND, NULL, NULL);
             
             // Course section
             CreateWindow("STATIC", "Course Name:", WS_VISIBLE | WS_CHILD,
@@ -246,9 +174,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                                       130, 120, 80, 200, hwnd, NULL, NULL, NULL);
             
             // Add grades to combo box
-            const char *grades[] = {"A+", "A", "A-", "B+", "B", "B-", "C+", "C", "C-", "D+", "D", "D-", "F"};
-            for (int i = 0; i < 13; i++) {
-                SendMessage(hGradeCombo, CB_ADDSTRING, 0, (LPARAM)grades[i]);
+            for (int i = 0; i < GRADE_COUNT; i++) {
+                SendMessage(hGradeCombo, CB_ADDSTRING, 0, (LPARAM)gradeLetters[i]);
             }
             SendMessage(hGradeCombo, CB_SETCURSEL, 0, 0);
             
@@ -260,72 +187,39 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             
             // Buttons
             hAddCourseBtn = CreateWindow("BUTTON", "Add Course", WS_VISIBLE | WS_CHILD,
-                                       290, 60, 90, 20, hwnd, (HMENU)2, NULL, NULL);
+                                       290, 60, 90, 20, hwnd, (HMENU)CMD_ADD_COURSE, NULL, NULL);
             hCalcGPABtn = CreateWindow("BUTTON", "Calculate GPA", WS_VISIBLE | WS_CHILD,
-                                     20, 330, 120, 30, hwnd, (HMENU)3, NULL, NULL);
+                                     20, 330, 120, 30, hwnd, (HMENU)CMD_CALCULATE_GPA, NULL, NULL);
             hClearBtn = CreateWindow("BUTTON", "Clear Form", WS_VISIBLE | WS_CHILD,
-                                   150, 330, 120, 30, hwnd, (HMENU)4, NULL, NULL);
+                                   150, 330, 120, 30, hwnd, (HMENU)CMD_CLEAR_FORM, NULL, NULL);
             
             // Output area
             hOutputEdit = CreateWindow("EDIT", "", WS_VISIBLE | WS_CHILD | WS_BORDER | ES_MULTILINE | ES_READONLY,
                                      20, 370, 560, 80, hwnd, NULL, NULL, NULL);
             
+            if (!viewInit(&viewModel, &listViewOps, NULL, students, MAX_STUDENTS)) {
+                return -1;
+            }
+            controllerInit(&controller, students, MAX_STUDENTS, &viewModel);
+            
             break;
         }
         
         case WM_COMMAND: {
             switch (LOWORD(wParam)) {
-                case 1: // Add Student
-                    if (studentCount >= MAX_STUDENTS) {
-                        MessageBox(hwnd, "Maximum number of students reached.", "Warning", MB_OK | MB_ICONWARNING);
-                        break;
-                    }
-                    
-                    char studentName[NAME_LENGTH];
-                    GetWindowText(hStudentNameEdit, studentName, NAME_LENGTH);
-                    
-                    if (strlen(studentName) == 0) {
-                        MessageBox(hwnd, "Please enter a student name.", "Error", MB_OK | MB_ICONERROR);
-                        break;
-                    }
-                    
-                    // Create new student
-                    strcpy(students[studentCount].name, studentName);
-                    students[studentCount].courseCount = 0;
-                    students[studentCount].gpa = 0.0f;
-                    
-                    // Add to list and select
-                    SendMessage(hStudentList, LB_ADDSTRING, 0, (LPARAM)studentName);
-                    SendMessage(hStudentList, LB_SETCURSEL, studentCount, 0);
-                    
-                    currentStudent = studentCount;
-                    studentCount++;
-                    
-                    // Clear form for new student
-                    clearCurrentForm();
-                    SetWindowText(hStudentNameEdit, "");
-                    break;
-                    
-                case 2: // Add Course
-                    addCourse();
-                    break;
-                    
-                case 3: // Calculate GPA
-                    calculateGPA(currentStudent);
-                    break;
-                    
-                case 4: // Clear Form
-                    clearCurrentForm();
-                    break;
-                    
-                case 5: // Switch Student
-                    switchStudent();
+                case CMD_ADD_STUDENT:
+                case CMD_ADD_COURSE:
+                case CMD_CALCULATE_GPA:
+                case CMD_CLEAR_FORM:
+                case CMD_SWITCH_STUDENT:
+                case CMD_FIND:
+                    runCommand(LOWORD(wParam));
                     break;
             }
             
             // Handle student list selection
             if (HIWORD(wParam) == LBN_SELCHANGE && (HWND)lParam == hStudentList) {
-                switchStudent();
+                runCommand(CMD_SELCHANGE);
             }
             
             break;
@@ -344,6 +238,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 
 // Entry point
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    // Optional session recording
+    const char *recordPath = getenv("GPA_RECORD");
+    if (recordPath != NULL && recordPath[0] != '\0') {
+        recordFile = fopen(recordPath, "a");
+    }
+    
     // Register window class
     const char CLASS_NAME[] = "GPACalculatorClass";
     
@@ -379,5 +279,18 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         DispatchMessage(&msg);
     }
     
+    if (recordFile != NULL) {
+        fclose(recordFile);
+    }
+    
+#ifdef GPA_STATS
+    // Instrumented builds dump their histograms to GPA_STATS_FILE on exit
+    const char *statsPath = getenv("GPA_STATS_FILE");
+    FILE *statsFile = statsPath != NULL ? fopen(statsPath, "w") : NULL;
+    if (statsFile != NULL) {
+        statsDump(statsFile);
+        fclose(statsFile);
+    }
+#endif
     return 0;
 }
@@ -0,0 +1,33 @@
+#ifndef GPA_CHECK_H
+#define GPA_CHECK_H
+
+#include <stdio.h>
+
+// Check counting for the headless test programs (gpa_*_test.c): each
+// failed check prints its line, and main reports the totals and returns
+// checkFailures > 0.
+
+static int checkTotal = 0;
+static int checkFailures = 0;
+
+#define CHECK_COUNT(what, actual, expected) checkCount(__LINE__, what, (long long)(actual), (long long)(expected))
+
+// Returns whether the check passed, so a caller can skip checks that
+// depend on it
+static int checkCount(int line, const char *what, long long actual, long long expected) {
+    checkTotal++;
+    if (actual != expected) {
+        checkFailures++;
+        printf("line %d: %s is %lld, expected %lld\n", line, what, actual, expected);
+        return 0;
+    }
+    return 1;
+}
+
+// Print "<name>: N checks, M failed"; returns the exit status
+static int checkReport(const char *name) {
+    printf("%s: %d checks, %d failed\n", name, checkTotal, checkFailures);
+    return checkFailures > 0;
+}
+
+#endif
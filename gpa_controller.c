@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_controller.h"
+#include "gpa_stats.h"
+
+// Without memory for the standing rules or the name index the calculator
+// still runs, without flags or Find
+void controllerInit(Controller *controller, Student *students, int maxStudents, ViewModel *view) {
+    memset(controller, 0, sizeof(*controller));
+    controller->students = students;
+    controller->maxStudents = maxStudents;
+    controller->view = view;
+
+    controller->standingRules = malloc(sizeof(RuleSet));
+    if (controller->standingRules != NULL && !rulesCompile(controller->standingRules, defaultStandingRules)) {
+        free(controller->standingRules);
+        controller->standingRules = NULL;
+    }
+    controller->nameIndex = malloc(sizeof(SearchIndex));
+    if (controller->nameIndex != NULL && !searchInit(controller->nameIndex)) {
+        free(controller->nameIndex);
+        controller->nameIndex = NULL;
+    }
+}
+
+// Stop using the name index after an add it could not take
+static void dropNameIndex(Controller *controller) {
+    if (controller->nameIndex == NULL) return;
+    searchFree(controller->nameIndex);
+    free(controller->nameIndex);
+    controller->nameIndex = NULL;
+}
+
+void controllerFree(Controller *controller) {
+    dropNameIndex(controller);
+    free(controller->standingRules);
+    controller->standingRules = NULL;
+}
+
+// Form as the window shows it at startup and after a clear
+void controllerClearForm(ControllerForm *form) {
+    memset(form, 0, sizeof(*form));
+    form->selection = -1;
+}
+
+static void setMessage(ControllerReply *reply, ControllerSeverity severity, const char *message) {
+    reply->severity = severity;
+    reply->message = message;
+}
+
+// Clear Form: drop the current student's courses
+static void clearForm(Controller *controller, ControllerReply *reply) {
+    int i;
+
+    reply->clearCourseForm = 1;
+    if (controller->currentStudent >= 0 && controller->currentStudent < controller->studentCount) {
+        Student *student = &controller->students[controller->currentStudent];
+        if (controller->nameIndex != NULL) {
+            for (i = 0; i < student->courseCount; i++) searchRemoveCourse(controller->nameIndex, student->courses[i].name);
+        }
+        student->courseCount = 0;
+    }
+
+    viewBeginBatch(controller->view);
+    viewClearCourses(controller->view, controller->currentStudent);
+    viewSetOutput(controller->view, "");
+    viewEndBatch(controller->view);
+}
+
+static void addStudent(Controller *controller, const ControllerForm *form, ControllerReply *reply) {
+    Student *student;
+
+    if (controller->studentCount >= controller->maxStudents) {
+        setMessage(reply, CONTROLLER_WARNING, "Maximum number of students reached.");
+        return;
+    }
+    if (form->studentName[0] == '\0') {
+        setMessage(reply, CONTROLLER_ERROR, "Please enter a student name.");
+        return;
+    }
+
+    student = &controller->students[controller->studentCount];
+    strcpy(student->name, form->studentName);
+    student->courseCount = 0;
+    student->gpa = 0.0f;
+    if (controller->nameIndex != NULL &&
+        !searchAddStudent(controller->nameIndex, controller->studentCount, student->name)) {
+        dropNameIndex(controller);
+    }
+
+    // Add to the list, select it and start a clean form
+    viewBeginBatch(controller->view);
+    viewStudentsAdded(controller->view, controller->studentCount, 1);
+    viewSelectStudent(controller->view, controller->studentCount);
+    controller->currentStudent = controller->studentCount;
+    controller->studentCount++;
+    clearForm(controller, reply);
+    viewEndBatch(controller->view);
+    reply->clearStudentName = 1;
+}
+
+static void addCourse(Controller *controller, const ControllerForm *form, ControllerReply *reply) {
+    Student *student;
+    CourseResult status;
+    const char *letterGrade = form->grade >= 0 && form->grade < GRADE_COUNT ? gradeLetters[form->grade] : "";
+
+    if (controller->currentStudent < 0 || controller->currentStudent >= controller->studentCount) return;
+    student = &controller->students[controller->currentStudent];
+
+    STATS_BEGIN(STAT_ADD_COURSE);
+    status = studentAddCourse(student, form->courseName, atoi(form->credits), letterGrade);
+    if (status != COURSE_OK) {
+        STATS_ADD(STAT_COURSES_REJECTED, 1);
+        setMessage(reply, status == COURSE_ERR_FULL ? CONTROLLER_WARNING : CONTROLLER_ERROR,
+                   courseResultMessage(status));
+        STATS_END(STAT_ADD_COURSE);
+        return;
+    }
+    STATS_ADD(STAT_COURSES_ADDED, 1);
+
+    viewCoursesAppended(controller->view, controller->currentStudent);
+    if (controller->nameIndex != NULL && !searchAddCourse(controller->nameIndex, form->courseName)) {
+        dropNameIndex(controller);
+    }
+    reply->clearCourseForm = 1;
+    STATS_END(STAT_ADD_COURSE);
+}
+
+// Calculate GPA, show it with the standing flags and update the list row
+static void calculateGPA(Controller *controller, int index) {
+    Student *student;
+    int totalCredits = 0;
+    char result[LIST_ROW_LENGTH];
+
+    if (index < 0 || index >= controller->studentCount) return;
+    student = &controller->students[index];
+
+    STATS_BEGIN(STAT_CALCULATE_GPA);
+    computeStudentGPA(student, &totalCredits);
+    formatStudentSummary(result, sizeof(result), student, totalCredits);
+    if (controller->standingRules != NULL) appendStandingLine(result, sizeof(result), controller->standingRules, student);
+    viewBeginBatch(controller->view);
+    viewSetOutput(controller->view, result);
+    viewStudentChanged(controller->view, index);
+    viewSelectStudent(controller->view, index);
+    viewEndBatch(controller->view);
+    STATS_END(STAT_CALCULATE_GPA);
+}
+
+// Make a student current: their courses, and their GPA if calculated
+static void displayStudent(Controller *controller, int index) {
+    Student *student;
+
+    if (index < 0 || index >= controller->studentCount) return;
+
+    STATS_BEGIN(STAT_DISPLAY_STUDENT);
+    controller->currentStudent = index;
+    student = &controller->students[index];
+
+    viewBeginBatch(controller->view);
+    viewShowCourses(controller->view, index);
+    viewSelectStudent(controller->view, index);
+    if (student->gpa > 0) {
+        char result[LIST_ROW_LENGTH];
+        formatStudentSummary(result, sizeof(result), student, totalCreditHours(student));
+        viewSetOutput(controller->view, result);
+    } else {
+        viewSetOutput(controller->view, "");
+    }
+    viewEndBatch(controller->view);
+    STATS_END(STAT_DISPLAY_STUDENT);
+}
+
+// Find a student or course by name, tolerating typos; the best student
+// hit is selected and the ranked hits are listed in the output
+static void findName(Controller *controller, const ControllerForm *form, ControllerReply *reply) {
+    SearchHit hits[8];
+    char result[LIST_ROW_LENGTH];
+    int found, selected = -1;
+    int i;
+
+    if (controller->nameIndex == NULL) {
+        setMessage(reply, CONTROLLER_WARNING, "Search is unavailable: out of memory.");
+        return;
+    }
+    found = searchQuery(controller->nameIndex, form->find, hits, 8);
+    if (found < 0) {
+        viewSetOutput(controller->view, "");
+        setMessage(reply, CONTROLLER_ERROR, "Not enough memory to search.");
+        return;
+    }
+    if (found == 0) {
+        viewSetOutput(controller->view, "No matching student or course.");
+        return;
+    }
+
+    for (i = 0; i < found && selected < 0; i++) {
+        if (hits[i].kind == SEARCH_STUDENT) selected = hits[i].student;
+    }
+    formatSearchHits(result, sizeof(result), hits, found);
+
+    viewBeginBatch(controller->view);
+    if (selected >= 0) displayStudent(controller, selected);
+    viewSetOutput(controller->view, result);
+    viewEndBatch(controller->view);
+}
+
+// Run one button press (or CMD_SELCHANGE) against the form contents
+void controllerCommand(Controller *controller, int commandId, const ControllerForm *form, ControllerReply *reply) {
+    memset(reply, 0, sizeof(*reply));
+    switch (commandId) {
+        case CMD_ADD_STUDENT: addStudent(controller, form, reply); break;
+        case CMD_ADD_COURSE: addCourse(controller, form, reply); break;
+        case CMD_CALCULATE_GPA: calculateGPA(controller, controller->currentStudent); break;
+        case CMD_CLEAR_FORM: clearForm(controller, reply); break;
+        case CMD_SWITCH_STUDENT:
+        case CMD_SELCHANGE: {
+            STATS_BEGIN(STAT_SWITCH_STUDENT);
+            if (form->selection >= 0) displayStudent(controller, form->selection);
+            STATS_END(STAT_SWITCH_STUDENT);
+            break;
+        }
+        case CMD_FIND: findName(controller, form, reply); break;
+    }
+}
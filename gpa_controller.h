@@ -0,0 +1,67 @@
+#ifndef GPA_CONTROLLER_H
+#define GPA_CONTROLLER_H
+
+#include "gpa_core.h"
+#include "gpa_rules.h"
+#include "gpa_search.h"
+#include "gpa_viewmodel.h"
+
+// Headless controller of the advanced calculator: the roster and what each
+// button does to it. The front end reads its controls into a
+// ControllerForm, runs the command and applies the ControllerReply (clear
+// fields, show a message box); list and output updates go through the
+// view model. The Win32 window and the replay harness both drive this
+// code, so a replayed recording runs exactly what the UI runs.
+
+// WM_COMMAND ids of the advanced calculator's buttons
+#define CMD_ADD_STUDENT 1
+#define CMD_ADD_COURSE 2
+#define CMD_CALCULATE_GPA 3
+#define CMD_CLEAR_FORM 4
+#define CMD_SWITCH_STUDENT 5
+// Pseudo-id for LBN_SELCHANGE from the student list
+#define CMD_SELCHANGE 6
+#define CMD_FIND 7
+#define CMD_COUNT 8
+
+// Form contents a command reads
+typedef struct {
+    char studentName[NAME_LENGTH];
+    char courseName[NAME_LENGTH];
+    char credits[10];
+    int grade;                  // Index into gradeLetters, -1 for no selection
+    int selection;              // Student list selection, -1 for none
+    char find[SEARCH_MAX_QUERY];
+} ControllerForm;
+
+typedef enum {
+    CONTROLLER_NO_MESSAGE,
+    CONTROLLER_WARNING,
+    CONTROLLER_ERROR
+} ControllerSeverity;
+
+// What the front end does to its controls after a command
+typedef struct {
+    ControllerSeverity severity;
+    const char *message;        // Message box text when severity is set
+    int clearStudentName;       // Empty the Student Name edit
+    int clearCourseForm;        // Empty the course edits, select the first grade
+} ControllerReply;
+
+typedef struct {
+    Student *students;
+    int studentCount;
+    int maxStudents;
+    int currentStudent;
+    ViewModel *view;
+
+    RuleSet *standingRules;     // Compiled once; NULL if they did not compile
+    SearchIndex *nameIndex;     // Names for Find; NULL once an add fails
+} Controller;
+
+void controllerInit(Controller *controller, Student *students, int maxStudents, ViewModel *view);
+void controllerFree(Controller *controller);
+void controllerClearForm(ControllerForm *form);
+void controllerCommand(Controller *controller, int commandId, const ControllerForm *form, ControllerReply *reply);
+
+#endif
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <string.h>
+#include "gpa_core.h"
+
+const char *const gradeLetters[GRADE_COUNT] = {
+    "A+", "A", "A-", "B+", "B", "B-", "C+", "C", "C-", "D+", "D", "D-", "F"
+};
+
+// Convert letter grade to grade points
+float letterGradeToPoints(const char *grade) {
+    char letter = grade[0];
+    char modifier = grade[1];
+    float points = 0.0f;
+
+    // Base points for letter grade
+    switch (letter) {
+        case 'A': points = 4.0f; break;
+        case 'B': points = 3.0f; break;
+        case 'C': points = 2.0f; break;
+        case 'D': points = 1.0f; break;
+        case 'F': points = 0.0f; break;
+        default: return 0.0f;
+    }
+
+    // Adjust for + or - (except A+ remains 4.0)
+    if (modifier == '+' && letter != 'A') {
+        points += 0.3f;
+    } else if (modifier == '-') {
+        points -= 0.3f;
+    }
+
+    return points;
+}
+
+// Position of a letter grade in gradeLetters, or -1 if it is not one
+int gradeIndex(const char *letterGrade) {
+    int i;
+
+    for (i = 0; i < GRADE_COUNT; i++) {
+        if (strcmp(gradeLetters[i], letterGrade) == 0) return i;
+    }
+    return -1;
+}
+
+// Credit-weighted GPA of a student, without storing it in the student;
+// the one formula behind computeStudentGPA, for code that holds a const
+// Student. points, if not NULL, receives the grade points of each course.
+float weightedGPA(const Student *student, float *points, int *totalCredits) {
+    float totalPoints = 0.0f;
+    int credits = 0;
+    int i;
+
+    for (i = 0; i < student->courseCount; i++) {
+        const Course *course = &student->courses[i];
+        float gradePoints = letterGradeToPoints(course->letterGrade);
+        if (points != NULL) points[i] = gradePoints;
+        totalPoints += gradePoints * course->creditHours;
+        credits += course->creditHours;
+    }
+
+    if (totalCredits != NULL) {
+        *totalCredits = credits;
+    }
+    return credits > 0 ? totalPoints / credits : 0.0f;
+}
+
+// Calculate the credit-weighted GPA of a student and store it in student->gpa
+float computeStudentGPA(Student *student, int *totalCredits) {
+    float points[MAX_COURSES];
+    int i;
+
+    student->gpa = weightedGPA(student, points, totalCredits);
+    for (i = 0; i < student->courseCount; i++) {
+        student->courses[i].gradePoints = points[i];
+    }
+    return student->gpa;
+}
+
+// Sum of credit hours over all courses of a student
+int totalCreditHours(const Student *student) {
+    int credits = 0;
+    int i;
+
+    for (i = 0; i < student->courseCount; i++) {
+        credits += student->courses[i].creditHours;
+    }
+    return credits;
+}
+
+// Validate and append a course; the student is left untouched on error
+CourseResult studentAddCourse(Student *student, const char *name, int creditHours, const char *letterGrade) {
+    Course *course;
+
+    if (student->courseCount >= MAX_COURSES) return COURSE_ERR_FULL;
+    if (name == NULL || name[0] == '\0') return COURSE_ERR_NAME;
+    if (creditHours <= 0) return COURSE_ERR_CREDITS;
+    if (letterGrade == NULL || gradeIndex(letterGrade) < 0) return COURSE_ERR_GRADE;
+
+    course = &student->courses[student->courseCount];
+    strncpy(course->name, name, NAME_LENGTH - 1);
+    course->name[NAME_LENGTH - 1] = '\0';
+    strncpy(course->letterGrade, letterGrade, sizeof(course->letterGrade) - 1);
+    course->letterGrade[sizeof(course->letterGrade) - 1] = '\0';
+    course->creditHours = creditHours;
+    course->gradePoints = 0.0f;
+
+    student->courseCount++;
+    return COURSE_OK;
+}
+
+// User-facing message for a failed studentAddCourse
+const char *courseResultMessage(CourseResult result) {
+    switch (result) {
+        case COURSE_ERR_FULL: return "Maximum number of courses reached.";
+        case COURSE_ERR_NAME: return "Please enter a course name.";
+        case COURSE_ERR_CREDITS: return "Please enter valid credit hours.";
+        case COURSE_ERR_GRADE: return "Please select a grade.";
+        default: return "";
+    }
+}
+
+// "<course> - <credits> credits - <grade>" row of the courses listbox
+int formatCourseEntry(char *buf, size_t size, const Course *course) {
+    return snprintf(buf, size, "%s - %d credits - %s", course->name, course->creditHours, course->letterGrade);
+}
+
+// "<student> (GPA: x.xx)" row of the student listbox
+int formatStudentEntry(char *buf, size_t size, const Student *student) {
+    return snprintf(buf, size, "%s (GPA: %.2f)", student->name, student->gpa);
+}
+
+// Multi-line summary shown in the output box
+int formatStudentSummary(char *buf, size_t size, const Student *student, int totalCredits) {
+    return snprintf(buf, size, "Student: %s\r\nTotal Credits: %d\r\nGPA: %.2f",
+                    student->name, totalCredits, student->gpa);
+}
@@ -0,0 +1,54 @@
+#ifndef GPA_CORE_H
+#define GPA_CORE_H
+
+#include <stddef.h>
+
+// Constants
+#define MAX_STUDENTS 10
+#define MAX_COURSES 20
+#define NAME_LENGTH 100
+#define GRADE_COUNT 13
+
+// Structure for a course
+typedef struct {
+    char name[NAME_LENGTH];
+    char letterGrade[3];  // A+, B-, etc.
+    int creditHours;
+    float gradePoints;    // Calculated from letter grade
+} Course;
+
+// Structure for a student
+typedef struct {
+    char name[NAME_LENGTH];
+    Course courses[MAX_COURSES];
+    int courseCount;
+    float gpa;
+} Student;
+
+// Result of adding a course to a student
+typedef enum {
+    COURSE_OK = 0,
+    COURSE_ERR_FULL,      // MAX_COURSES reached
+    COURSE_ERR_NAME,      // Empty course name
+    COURSE_ERR_CREDITS,   // Credit hours <= 0
+    COURSE_ERR_GRADE      // No grade selected, or not one of gradeLetters
+} CourseResult;
+
+// Letter grades in combo box order, A+ through F
+extern const char *const gradeLetters[GRADE_COUNT];
+
+// Grading core shared by the Win32 front end and the headless tools
+float letterGradeToPoints(const char *grade);
+int gradeIndex(const char *letterGrade);
+float weightedGPA(const Student *student, float *points, int *totalCredits);
+float computeStudentGPA(Student *student, int *totalCredits);
+int totalCreditHours(const Student *student);
+CourseResult studentAddCourse(Student *student, const char *name, int creditHours, const char *letterGrade);
+const char *courseResultMessage(CourseResult result);
+
+// Display strings used by the listboxes and the output box
+int formatCourseEntry(char *buf, size_t size, const Course *course);
+int formatStudentEntry(char *buf, size_t size, const Student *student);
+int formatStudentSummary(char *buf, size_t size, const Student *student, int totalCredits);
+
+#endif
@@ -0,0 +1,332 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_diff.h"
+
+#define RADIX_BITS 16
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+typedef struct {
+    unsigned long long hash;
+    int index;
+} StudentKey;
+
+// Called once per student pair of the join; a missing side is -1
+typedef void (*PairFn)(void *context, int before, int after);
+
+typedef struct {
+    const Student *before;
+    const Student *after;
+    RosterChangeFn fn;
+    void *context;
+    DiffSummary summary;
+
+    // Merge plan, recorded while diffing when set
+    unsigned char *removed;     // Bit per before student
+    unsigned char *added;       // Bit per after student
+    int *changed;               // Before/after index pairs of changed students
+} DiffState;
+
+static unsigned long long hashName(const char *name) {
+    unsigned long long hash = 14695981039346656037ULL;
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Key order: hash, then name (for the rare collision), then roster position
+static int compareKeys(const StudentKey *x, const Student *xs, const StudentKey *y, const Student *ys) {
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return strcmp(xs[x->index].name, ys[y->index].name);
+}
+
+// Radix sort the roster's keys; returns NULL when out of memory
+static StudentKey *sortRoster(const Student *students, int count) {
+    StudentKey *keys = malloc(sizeof(StudentKey) * (count > 0 ? count : 1));
+    StudentKey *scratch = malloc(sizeof(StudentKey) * (count > 0 ? count : 1));
+    int *buckets = malloc(sizeof(int) * RADIX_SIZE);
+    int pass, i, j;
+
+    if (keys == NULL || scratch == NULL || buckets == NULL) {
+        free(keys);
+        free(scratch);
+        free(buckets);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        keys[i].hash = hashName(students[i].name);
+        keys[i].index = i;
+    }
+
+    // Least significant digit first; each pass is stable, so equal names keep roster order
+    for (pass = 0; pass < 64 / RADIX_BITS; pass++) {
+        int shift = pass * RADIX_BITS;
+        int total = 0;
+        StudentKey *swap;
+
+        memset(buckets, 0, sizeof(int) * RADIX_SIZE);
+        for (i = 0; i < count; i++) buckets[(keys[i].hash >> shift) & (RADIX_SIZE - 1)]++;
+        for (i = 0; i < RADIX_SIZE; i++) {
+            int size = buckets[i];
+            buckets[i] = total;
+            total += size;
+        }
+        for (i = 0; i < count; i++) scratch[buckets[(keys[i].hash >> shift) & (RADIX_SIZE - 1)]++] = keys[i];
+        swap = keys;
+        keys = scratch;
+        scratch = swap;
+    }
+
+    // Different names with the same hash: order them by name (insertion sort, stable)
+    for (i = 1; i < count; i++) {
+        if (keys[i].hash != keys[i - 1].hash) continue;
+        for (j = i; j > 0 && compareKeys(&keys[j - 1], students, &keys[j], students) > 0; j--) {
+            StudentKey swap = keys[j];
+            keys[j] = keys[j - 1];
+            keys[j - 1] = swap;
+        }
+    }
+
+    free(scratch);
+    free(buckets);
+    return keys;
+}
+
+// Merge join of two sorted key arrays
+static void joinKeys(const StudentKey *a, const Student *as, int na, const StudentKey *b, const Student *bs, int nb,
+                     PairFn pair, void *context) {
+    int i = 0, j = 0;
+
+    while (i < na || j < nb) {
+        int diff = i == na ? 1 : j == nb ? -1 : compareKeys(&a[i], as, &b[j], bs);
+        if (diff < 0) {
+            pair(context, a[i++].index, -1);
+        } else if (diff > 0) {
+            pair(context, -1, b[j++].index);
+        } else {
+            pair(context, a[i++].index, b[j++].index);
+        }
+    }
+}
+
+// Course positions of a student ordered by name; at most MAX_COURSES, so insertion sort
+static void sortCourses(const Student *student, unsigned char order[MAX_COURSES]) {
+    int i, j;
+
+    for (i = 0; i < student->courseCount; i++) {
+        unsigned char current = (unsigned char)i;
+        for (j = i; j > 0 && strcmp(student->courses[order[j - 1]].name, student->courses[current].name) > 0; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = current;
+    }
+}
+
+// Pair the courses of two students: match[k] is the after-course of before-course k, or -1
+static void matchCourses(const Student *before, const Student *after, signed char match[MAX_COURSES],
+                         unsigned char afterMatched[MAX_COURSES]) {
+    unsigned char a[MAX_COURSES], b[MAX_COURSES];
+    int i = 0, j = 0;
+
+    sortCourses(before, a);
+    sortCourses(after, b);
+    memset(afterMatched, 0, MAX_COURSES);
+    while (i < before->courseCount || j < after->courseCount) {
+        int diff = i == before->courseCount ? 1
+                   : j == after->courseCount ? -1
+                   : strcmp(before->courses[a[i]].name, after->courses[b[j]].name);
+        if (diff < 0) {
+            match[a[i++]] = -1;
+        } else if (diff > 0) {
+            j++;
+        } else {
+            match[a[i]] = (signed char)b[j];
+            afterMatched[b[j]] = 1;
+            i++;
+            j++;
+        }
+    }
+}
+
+static int courseDiffers(const Course *a, const Course *b) {
+    return a->creditHours != b->creditHours || strcmp(a->letterGrade, b->letterGrade) != 0;
+}
+
+static void emit(DiffState *state, DiffKind kind, const Student *before, const Student *after,
+                 const Course *beforeCourse, const Course *afterCourse) {
+    RosterChange change;
+
+    if (state->fn == NULL) return;
+    change.kind = kind;
+    change.before = before;
+    change.after = after;
+    change.beforeCourse = beforeCourse;
+    change.afterCourse = afterCourse;
+    change.gpaBefore = before != NULL ? weightedGPA(before, NULL, NULL) : 0.0f;
+    change.gpaAfter = after != NULL ? weightedGPA(after, NULL, NULL) : 0.0f;
+    state->fn(state->context, &change);
+}
+
+static void diffPair(void *context, int beforeIndex, int afterIndex) {
+    DiffState *state = context;
+    const Student *before = beforeIndex >= 0 ? &state->before[beforeIndex] : NULL;
+    const Student *after = afterIndex >= 0 ? &state->after[afterIndex] : NULL;
+    signed char match[MAX_COURSES];
+    unsigned char afterMatched[MAX_COURSES];
+    int changes = 0;
+    int k;
+
+    if (after == NULL) {
+        if (state->removed != NULL) state->removed[beforeIndex / 8] |= (unsigned char)(1 << (beforeIndex % 8));
+        state->summary.studentsRemoved++;
+        emit(state, DIFF_STUDENT_REMOVED, before, NULL, NULL, NULL);
+        return;
+    }
+    if (before == NULL) {
+        if (state->added != NULL) state->added[afterIndex / 8] |= (unsigned char)(1 << (afterIndex % 8));
+        state->summary.studentsAdded++;
+        emit(state, DIFF_STUDENT_ADDED, NULL, after, NULL, NULL);
+        return;
+    }
+
+    matchCourses(before, after, match, afterMatched);
+    for (k = 0; k < before->courseCount; k++) {
+        if (match[k] < 0) {
+            state->summary.coursesRemoved++;
+            emit(state, DIFF_COURSE_REMOVED, before, after, &before->courses[k], NULL);
+            changes++;
+        } else if (courseDiffers(&before->courses[k], &after->courses[match[k]])) {
+            state->summary.coursesChanged++;
+            emit(state, DIFF_COURSE_CHANGED, before, after, &before->courses[k], &after->courses[match[k]]);
+            changes++;
+        }
+    }
+    for (k = 0; k < after->courseCount; k++) {
+        if (!afterMatched[k]) {
+            state->summary.coursesAdded++;
+            emit(state, DIFF_COURSE_ADDED, before, after, NULL, &after->courses[k]);
+            changes++;
+        }
+    }
+
+    if (changes > 0) {
+        if (state->changed != NULL) {
+            state->changed[2 * state->summary.studentsChanged] = beforeIndex;
+            state->changed[2 * state->summary.studentsChanged + 1] = afterIndex;
+        }
+        state->summary.studentsChanged++;
+        if (weightedGPA(before, NULL, NULL) != weightedGPA(after, NULL, NULL)) emit(state, DIFF_GPA_CHANGED, before, after, NULL, NULL);
+    }
+}
+
+// Stream the changes that turn before into after; returns 0 when out of memory
+int rosterDiff(const Student *before, int beforeCount, const Student *after, int afterCount,
+               RosterChangeFn fn, void *context, DiffSummary *summary) {
+    StudentKey *a = sortRoster(before, beforeCount);
+    StudentKey *b = sortRoster(after, afterCount);
+    DiffState state;
+
+    if (a == NULL || b == NULL) {
+        free(a);
+        free(b);
+        return 0;
+    }
+    memset(&state, 0, sizeof(state));
+    state.before = before;
+    state.after = after;
+    state.fn = fn;
+    state.context = context;
+    joinKeys(a, before, beforeCount, b, after, afterCount, diffPair, &state);
+
+    if (summary != NULL) *summary = state.summary;
+    free(a);
+    free(b);
+    return 1;
+}
+
+// Kept courses stay in place with the incoming credits and grade, removed
+// ones drop out and new ones are appended in incoming order
+static void applyCourses(Student *student, const Student *incoming) {
+    signed char match[MAX_COURSES];
+    unsigned char incomingMatched[MAX_COURSES];
+    int kept = 0;
+    int k;
+
+    matchCourses(student, incoming, match, incomingMatched);
+    for (k = 0; k < student->courseCount; k++) {
+        if (match[k] < 0) continue;
+        student->courses[kept] = student->courses[k];
+        student->courses[kept].creditHours = incoming->courses[match[k]].creditHours;
+        strcpy(student->courses[kept].letterGrade, incoming->courses[match[k]].letterGrade);
+        kept++;
+    }
+    for (k = 0; k < incoming->courseCount; k++) {
+        if (!incomingMatched[k]) student->courses[kept++] = incoming->courses[k];
+    }
+    student->courseCount = kept;
+    computeStudentGPA(student, NULL);
+}
+
+// Reconcile students with an incoming roster in one batch: changed students
+// are updated in place, removed ones are dropped (the rest keep their
+// order) and new ones are appended. The join runs once; it streams the
+// changes to fn and records the plan (two bits per student and an index
+// pair per changed student), which is applied only if it fits. Returns 0
+// and leaves students untouched when out of memory or when the result
+// would not fit in capacity.
+int rosterMerge(Student *students, int *count, int capacity, const Student *incoming, int incomingCount,
+                RosterChangeFn fn, void *context, DiffSummary *summary) {
+    int pairs = *count < incomingCount ? *count : incomingCount;
+    StudentKey *a = sortRoster(students, *count);
+    StudentKey *b = sortRoster(incoming, incomingCount);
+    unsigned char *removed = calloc((size_t)*count / 8 + 1, 1);
+    unsigned char *added = calloc((size_t)incomingCount / 8 + 1, 1);
+    int *changed = malloc(sizeof(int) * 2 * (pairs > 0 ? pairs : 1));
+    DiffState diff;
+    int ok = 0;
+    int i, kept;
+
+    if (a != NULL && b != NULL && removed != NULL && added != NULL && changed != NULL) {
+        memset(&diff, 0, sizeof(diff));
+        diff.before = students;
+        diff.after = incoming;
+        diff.fn = fn;
+        diff.context = context;
+        diff.removed = removed;
+        diff.added = added;
+        diff.changed = changed;
+        joinKeys(a, students, *count, b, incoming, incomingCount, diffPair, &diff);
+        if (summary != NULL) *summary = diff.summary;
+
+        ok = *count - diff.summary.studentsRemoved + diff.summary.studentsAdded <= capacity;
+    }
+    free(a);
+    free(b);
+
+    if (ok) {
+        for (i = 0; i < diff.summary.studentsChanged; i++) {
+            applyCourses(&students[changed[2 * i]], &incoming[changed[2 * i + 1]]);
+        }
+
+        kept = 0;
+        for (i = 0; i < *count; i++) {
+            if (removed[i / 8] & (1 << (i % 8))) continue;
+            if (kept != i) students[kept] = students[i];
+            kept++;
+        }
+        for (i = 0; i < incomingCount; i++) {
+            if (!(added[i / 8] & (1 << (i % 8)))) continue;
+            students[kept] = incoming[i];
+            computeStudentGPA(&students[kept], NULL);
+            kept++;
+        }
+        *count = kept;
+    }
+
+    free(removed);
+    free(added);
+    free(changed);
+    return ok;
+}
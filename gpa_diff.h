@@ -0,0 +1,47 @@
+#ifndef GPA_DIFF_H
+#define GPA_DIFF_H
+
+#include "gpa_core.h"
+
+// Roster reconciliation. Students are matched by name, the key the import
+// format and the UI use, and courses within a student by course name.
+// Both rosters are radix-sorted by a 64-bit name hash into small key
+// arrays (16 bytes per student, the Student data is not moved), then a
+// merge join walks them once and streams the differences. Repeated names
+// pair up in roster order.
+
+typedef enum {
+    DIFF_STUDENT_ADDED,
+    DIFF_STUDENT_REMOVED,
+    DIFF_COURSE_ADDED,
+    DIFF_COURSE_REMOVED,
+    DIFF_COURSE_CHANGED,    // Same course, different credits or grade
+    DIFF_GPA_CHANGED
+} DiffKind;
+
+typedef struct {
+    DiffKind kind;
+    const Student *before;          // NULL for an added student
+    const Student *after;           // NULL for a removed student
+    const Course *beforeCourse;     // Course events only
+    const Course *afterCourse;
+    float gpaBefore, gpaAfter;
+} RosterChange;
+
+typedef struct {
+    int studentsAdded;
+    int studentsRemoved;
+    int studentsChanged;            // Matched students with any course change
+    int coursesAdded;
+    int coursesRemoved;
+    int coursesChanged;
+} DiffSummary;
+
+typedef void (*RosterChangeFn)(void *context, const RosterChange *change);
+
+int rosterDiff(const Student *before, int beforeCount, const Student *after, int afterCount,
+               RosterChangeFn fn, void *context, DiffSummary *summary);
+int rosterMerge(Student *students, int *count, int capacity, const Student *incoming, int incomingCount,
+                RosterChangeFn fn, void *context, DiffSummary *summary);
+
+#endif
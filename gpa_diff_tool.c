@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_diff.h"
+#include "gpa_import.h"
+#include "gpa_roster_gen.h"
+#include "gpa_timer.h"
+
+// Compares two rosters in the import format and optionally writes the
+// merged result. Changes are printed one per line:
+//   + student NAME            - student NAME
+//   + course NAME COURSE ...  - course NAME COURSE ...
+//   ~ course NAME COURSE old -> new
+//   ~ gpa NAME old -> new
+// --generate builds a roster and a modified copy in memory instead, and
+// checks that merging leaves no differences.
+
+typedef struct {
+    FILE *out;
+    long long changes;
+} Printer;
+
+static void printChange(void *context, const RosterChange *change) {
+    Printer *printer = context;
+    FILE *out = printer->out;
+
+    printer->changes++;
+    if (out == NULL) return;
+    switch (change->kind) {
+        case DIFF_STUDENT_ADDED:
+            fprintf(out, "+ student\t%s\t%.2f\n", change->after->name, change->gpaAfter);
+            break;
+        case DIFF_STUDENT_REMOVED:
+            fprintf(out, "- student\t%s\t%.2f\n", change->before->name, change->gpaBefore);
+            break;
+        case DIFF_COURSE_ADDED:
+            fprintf(out, "+ course\t%s\t%s\t%d\t%s\n", change->after->name, change->afterCourse->name,
+                    change->afterCourse->creditHours, change->afterCourse->letterGrade);
+            break;
+        case DIFF_COURSE_REMOVED:
+            fprintf(out, "- course\t%s\t%s\t%d\t%s\n", change->before->name, change->beforeCourse->name,
+                    change->beforeCourse->creditHours, change->beforeCourse->letterGrade);
+            break;
+        case DIFF_COURSE_CHANGED:
+            fprintf(out, "~ course\t%s\t%s\t%d %s -> %d %s\n", change->before->name, change->beforeCourse->name,
+                    change->beforeCourse->creditHours, change->beforeCourse->letterGrade,
+                    change->afterCourse->creditHours, change->afterCourse->letterGrade);
+            break;
+        case DIFF_GPA_CHANGED:
+            fprintf(out, "~ gpa\t%s\t%.2f -> %.2f\n", change->before->name, change->gpaBefore, change->gpaAfter);
+            break;
+    }
+}
+
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (file == NULL) return NULL;
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    data = malloc((size_t)size + 1);
+    if (data != NULL) {
+        *length = fread(data, 1, (size_t)size, file);
+        data[*length] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+// Load a roster file; capacity leaves room for students a merge may add
+static Student *loadRoster(const char *path, int extra, int *count, int *capacity) {
+    size_t length;
+    char *text = readFile(path, &length);
+    Student *students;
+
+    if (text == NULL) return NULL;
+    *capacity = extra + 1;
+    for (size_t i = 0; i < length; i++) *capacity += text[i] == '\n';
+    students = malloc(sizeof(Student) * *capacity);
+    if (students != NULL) *count = importRoster(text, length, students, *capacity, NULL);
+    free(text);
+    return students;
+}
+
+// Copy of the roster with percent% of the students changed, a quarter as
+// many removed and as many new ones added
+static void mutateRoster(RosterGen *gen, const Student *source, int count, int percent, Student *target,
+                         int *targetCount) {
+    int n = 0;
+
+    for (int i = 0; i < count; i++) {
+        unsigned int r = rosterGenRandom(gen) % 400;
+        if (r < (unsigned int)percent) continue;                // Left the roster
+        target[n] = source[i];
+        Student *student = &target[n++];
+        if (r >= (unsigned int)percent * 4) continue;           // Unchanged
+        if (r % 3 == 0 && student->courseCount > 1) {
+            int drop = rosterGenRandom(gen) % student->courseCount;
+            student->courses[drop] = student->courses[--student->courseCount];
+        } else if (r % 3 == 1) {
+            Course *course = &student->courses[rosterGenRandom(gen) % student->courseCount];
+            strcpy(course->letterGrade, gradeLetters[rosterGenRandom(gen) % GRADE_COUNT]);
+        } else if (student->courseCount < MAX_COURSES) {
+            sprintf(student->courses[student->courseCount].name, "NEW %u", rosterGenRandom(gen) % 1000);
+            student->courses[student->courseCount].creditHours = 3;
+            strcpy(student->courses[student->courseCount].letterGrade, "B");
+            student->courseCount++;
+        }
+    }
+    // New students, as many as left
+    for (int i = 0; i < count * percent / 400; i++) rosterGenStudent(gen, &target[n++]);
+    *targetCount = n;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s BEFORE AFTER [--apply OUT] [--quiet]\n"
+            "       %s --generate STUDENTS [--change PERCENT] [--seed N] [--quiet]\n"
+            "  BEFORE, AFTER  rosters in the import format\n"
+            "  --apply OUT    write BEFORE merged with AFTER to OUT\n"
+            "  --change       percent of students changed (default 5); a quarter as many\n"
+            "                 are removed and as many added\n",
+            program, program);
+}
+
+int main(int argc, char **argv) {
+    const char *paths[2] = {NULL, NULL};
+    const char *applyPath = NULL;
+    int generate = 0, percent = 5, quiet = 0, pathCount = 0;
+    unsigned long long seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--apply") == 0 && value != NULL) {
+            applyPath = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0 && value != NULL) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--change") == 0 && value != NULL) {
+            percent = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (argv[i][0] != '-' && pathCount < 2) {
+            paths[pathCount++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((generate > 0) == (pathCount == 2) || percent < 0 || percent > 100) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Student *before, *after;
+    int beforeCount, afterCount, capacity, afterCapacity;
+    if (generate > 0) {
+        RosterGenOptions options;
+        RosterGen gen;
+        rosterGenDefaults(&options);
+        options.seed = seed;
+        rosterGenInit(&gen, &options);
+        capacity = generate + generate / 4 + 1;
+        before = malloc(sizeof(Student) * capacity);
+        after = malloc(sizeof(Student) * capacity);
+        if (before == NULL || after == NULL) {
+            fprintf(stderr, "Out of memory for %d students\n", generate);
+            return 1;
+        }
+        beforeCount = generate;
+        rosterGenFill(&gen, before, beforeCount);
+        mutateRoster(&gen, before, beforeCount, percent, after, &afterCount);
+    } else {
+        after = loadRoster(paths[1], 0, &afterCount, &afterCapacity);
+        before = after != NULL ? loadRoster(paths[0], afterCount, &beforeCount, &capacity) : NULL;
+        if (before == NULL) {
+            fprintf(stderr, "Cannot read %s\n", after == NULL ? paths[1] : paths[0]);
+            return 1;
+        }
+    }
+
+    Printer printer = {quiet ? NULL : stdout, 0};
+    DiffSummary summary;
+    long long start = nowNanoseconds();
+    if (!rosterDiff(before, beforeCount, after, afterCount, printChange, &printer, &summary)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    long long diffed = nowNanoseconds();
+
+    // Merge and, for generated rosters, confirm nothing is left to change
+    long long merged = diffed, remaining = -1;
+    if (generate > 0 || applyPath != NULL) {
+        if (!rosterMerge(before, &beforeCount, capacity, after, afterCount, NULL, NULL, NULL)) {
+            fprintf(stderr, "Merge failed: out of memory\n");
+            return 1;
+        }
+        merged = nowNanoseconds();
+        if (generate > 0) {
+            Printer check = {NULL, 0};
+            rosterDiff(before, beforeCount, after, afterCount, printChange, &check, NULL);
+            remaining = check.changes;
+        }
+    }
+    if (applyPath != NULL) {
+        size_t length;
+        char *text = exportRoster(before, beforeCount, &length);
+        FILE *file;
+        int written;
+
+        // Leave the old file alone if the export itself failed
+        if (text == NULL) {
+            fprintf(stderr, "Cannot export the merged roster: out of memory\n");
+            return 1;
+        }
+        file = fopen(applyPath, "wb");
+        written = file != NULL && fwrite(text, 1, length, file) == length;
+        if (file != NULL && fclose(file) != 0) written = 0;
+        free(text);
+        if (!written) {
+            fprintf(stderr, "Cannot write %s\n", applyPath);
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "{\"students_added\":%d,\"students_removed\":%d,\"students_changed\":%d,"
+            "\"courses_added\":%d,\"courses_removed\":%d,\"courses_changed\":%d,\"changes\":%lld,"
+            "\"diff_ms\":%.1f,\"merge_ms\":%.1f,\"remaining_after_merge\":%lld}\n",
+            summary.studentsAdded, summary.studentsRemoved, summary.studentsChanged, summary.coursesAdded,
+            summary.coursesRemoved, summary.coursesChanged, printer.changes, (diffed - start) / 1e6,
+            (merged - diffed) / 1e6, remaining);
+    free(before);
+    free(after);
+    return remaining > 0 ? 1 : 0;
+}
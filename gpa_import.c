@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_import.h"
+#include "gpa_stats.h"
+
+// Write a roster in the import format; the caller frees the returned buffer
+char *exportRoster(const Student *students, int count, size_t *length) {
+    size_t capacity = 4096;
+    size_t used = 0;
+    char *text = malloc(capacity);
+    int i, j;
+
+    if (text == NULL) return NULL;
+    STATS_BEGIN(STAT_EXPORT_ROSTER);
+
+    for (i = 0; i < count; i++) {
+        const Student *student = &students[i];
+        for (j = 0; j < student->courseCount; j++) {
+            const Course *course = &student->courses[j];
+            // Longest line: two names, an int, a grade and separators
+            if (used + 2 * NAME_LENGTH + 32 > capacity) {
+                char *grown;
+                capacity *= 2;
+                grown = realloc(text, capacity);
+                if (grown == NULL) {
+                    free(text);
+                    return NULL;
+                }
+                text = grown;
+            }
+            used += (size_t)sprintf(text + used, "%s\t%s\t%d\t%s\n",
+                                    student->name, course->name, course->creditHours, course->letterGrade);
+        }
+    }
+
+    text[used] = '\0';
+    STATS_END(STAT_EXPORT_ROSTER);
+    if (length != NULL) *length = used;
+    return text;
+}
+
+// Copy one tab-delimited field into out, returning the position after the delimiter
+static const char *readField(const char *p, const char *end, char *out, size_t size) {
+    size_t n = 0;
+
+    while (p < end && *p != '\t' && *p != '\n' && *p != '\r') {
+        if (n + 1 < size) out[n++] = *p;
+        p++;
+    }
+    out[n] = '\0';
+    if (p < end && *p == '\t') p++;
+    return p;
+}
+
+// Parse roster text into students; returns the number of students filled
+int importRoster(const char *text, size_t length, Student *students, int maxStudents, ImportStats *stats) {
+    const char *p = text;
+    const char *end = text + length;
+    int count = 0;
+    int rows = 0;
+    int skipped = 0;
+    int i;
+
+    STATS_BEGIN(STAT_IMPORT_ROSTER);
+    while (p < end) {
+        char studentName[NAME_LENGTH];
+        char courseName[NAME_LENGTH];
+        char creditStr[16];
+        char letterGrade[8];    // Room to see that "A+x" is not a grade
+        const char *lineEnd = memchr(p, '\n', (size_t)(end - p));
+        if (lineEnd == NULL) lineEnd = end;
+
+        if (lineEnd == p || (lineEnd - p == 1 && *p == '\r')) {
+            p = lineEnd + 1;
+            continue;
+        }
+
+        p = readField(p, lineEnd, studentName, sizeof(studentName));
+        p = readField(p, lineEnd, courseName, sizeof(courseName));
+        p = readField(p, lineEnd, creditStr, sizeof(creditStr));
+        p = readField(p, lineEnd, letterGrade, sizeof(letterGrade));
+        p = lineEnd + 1;
+        rows++;
+
+        if (studentName[0] == '\0') {
+            skipped++;
+            continue;
+        }
+
+        // Start a new student when the name changes
+        if (count == 0 || strcmp(students[count - 1].name, studentName) != 0) {
+            if (count >= maxStudents) {
+                skipped++;
+                continue;
+            }
+            strcpy(students[count].name, studentName);
+            students[count].courseCount = 0;
+            students[count].gpa = 0.0f;
+            count++;
+        }
+
+        if (studentAddCourse(&students[count - 1], courseName, atoi(creditStr), letterGrade) != COURSE_OK) {
+            skipped++;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        computeStudentGPA(&students[i], NULL);
+    }
+
+    if (stats != NULL) {
+        stats->rows = rows;
+        stats->skipped = skipped;
+    }
+    STATS_ADD(STAT_ROWS_IMPORTED, rows - skipped);
+    STATS_ADD(STAT_ROWS_SKIPPED, skipped);
+    STATS_END(STAT_IMPORT_ROSTER);
+    return count;
+}
@@ -0,0 +1,19 @@
+#ifndef GPA_IMPORT_H
+#define GPA_IMPORT_H
+
+#include <stddef.h>
+#include "gpa_core.h"
+
+// Roster text format: one course per line,
+//   <student name> TAB <course name> TAB <credit hours> TAB <letter grade>
+// Consecutive lines with the same student name belong to the same student.
+
+typedef struct {
+    int rows;       // Course lines read
+    int skipped;    // Lines rejected by studentAddCourse or malformed
+} ImportStats;
+
+char *exportRoster(const Student *students, int count, size_t *length);
+int importRoster(const char *text, size_t length, Student *students, int maxStudents, ImportStats *stats);
+
+#endif
@@ -0,0 +1,161 @@
+#include <string.h>
+#include "gpa_numeric.h"
+
+// Exact powers of ten representable in a double
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double scaleByPowerOfTen(double value, int exponent) {
+    while (exponent > 22) {
+        value *= 1e22;
+        exponent -= 22;
+    }
+    while (exponent < -22) {
+        value /= 1e22;
+        exponent += 22;
+    }
+    return exponent >= 0 ? value * powers_of_ten[exponent] : value / powers_of_ten[-exponent];
+}
+
+// Locale-free decimal parser: [spaces][+-]digits[.digits][e[+-]digits].
+// Always uses '.' as the decimal point, unlike atof/strtod. Grades have few
+// digits, so mantissa * 10^exp is exact and this matches strtod for them.
+int parseGrade(const char *text, const char **end, float *value) {
+    const char *p = text;
+    unsigned long long mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    int negative = 0;
+
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        p++;
+    }
+
+    while (*p >= '0' && *p <= '9') {
+        if (mantissa < 1000000000000000000ULL) {
+            mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+        } else {
+            exponent++;
+        }
+        digits++;
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        while (*p >= '0' && *p <= '9') {
+            if (mantissa < 1000000000000000000ULL) {
+                mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+                exponent--;
+            }
+            digits++;
+            p++;
+        }
+    }
+    if (digits == 0) {
+        if (end != NULL) *end = text;
+        return 0;
+    }
+
+    if (*p == 'e' || *p == 'E') {
+        const char *q = p + 1;
+        int exponent_negative = 0;
+        int explicit_exponent = 0;
+        if (*q == '+' || *q == '-') {
+            exponent_negative = *q == '-';
+            q++;
+        }
+        if (*q >= '0' && *q <= '9') {
+            while (*q >= '0' && *q <= '9') {
+                if (explicit_exponent < 10000) explicit_exponent = explicit_exponent * 10 + (*q - '0');
+                q++;
+            }
+            exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+            p = q;
+        }
+    }
+
+    double result = scaleByPowerOfTen((double)mantissa, exponent);
+    *value = (float)(negative ? -result : result);
+    if (end != NULL) *end = p;
+    return 1;
+}
+
+// Sums in double like numericBatch, so both paths give the same average
+float averageGrades(const float *grades, int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += grades[i];
+    }
+    return count > 0 ? (float)(sum / count) : 0.0f;
+}
+
+void numericDefaults(NumericOptions *options) {
+    options->delimiter = ',';
+    options->min_grade = 0.0f;
+    options->max_grade = 100.0f;
+}
+
+// Parse every line of a grade sheet and report each student's average
+void numericBatch(const char *text, size_t length, const NumericOptions *options,
+                  NumericRowFn on_row, void *context, NumericStats *stats) {
+    const char *p = text;
+    const char *text_end = text + length;
+    NumericStats totals = {0, 0, 0, 0};
+
+    while (p < text_end) {
+        const char *line_end = memchr(p, '\n', (size_t)(text_end - p));
+        if (line_end == NULL) line_end = text_end;
+
+        const char *name_end = memchr(p, options->delimiter, (size_t)(line_end - p));
+        if (name_end == NULL) name_end = line_end;
+        const char *name = p;
+        size_t name_length = (size_t)(name_end - name);
+        if (name_length > 0 && name[name_length - 1] == '\r') name_length--;
+
+        if (name_length == 0 && name_end == line_end) {
+            p = line_end + 1;
+            continue;
+        }
+
+        // Sum in double: rows may hold thousands of grades
+        double sum = 0.0;
+        int count = 0;
+        int rejected = 0;
+        p = name_end;
+        while (p < line_end) {
+            float grade;
+            const char *after;
+            p++;   // Skip the delimiter
+            if (parseGrade(p, &after, &grade)) {
+                while (after < line_end && (*after == ' ' || *after == '\r')) after++;
+            }
+            if (after == p || (after < line_end && *after != options->delimiter)) {
+                // Not a number: skip the field
+                totals.malformed++;
+                rejected++;
+                after = memchr(p, options->delimiter, (size_t)(line_end - p));
+                if (after == NULL) after = line_end;
+            } else if (grade < options->min_grade || grade > options->max_grade) {
+                totals.out_of_range++;
+                rejected++;
+            } else {
+                sum += grade;
+                count++;
+            }
+            p = after;
+        }
+
+        totals.rows++;
+        totals.grades += count + rejected;
+        if (on_row != NULL) {
+            on_row(context, name, name_length, count > 0 ? (float)(sum / count) : 0.0f, count, rejected);
+        }
+        p = line_end + 1;
+    }
+
+    if (stats != NULL) *stats = totals;
+}
@@ -0,0 +1,36 @@
+#ifndef GPA_NUMERIC_H
+#define GPA_NUMERIC_H
+
+#include <stddef.h>
+
+// Numeric grades as used by the simple calculator (gpa_calculator.c):
+// a student's GPA is the plain average of their grades.
+
+// Batch input: one student per line, "name,grade,grade,..." with any
+// number of grades. Grades outside [min_grade, max_grade] or that do not
+// parse are left out of the average and counted as rejected. The byte at
+// text[length] must be readable and not a digit, e.g. a terminating '\0'.
+typedef struct {
+    char delimiter;
+    float min_grade;
+    float max_grade;
+} NumericOptions;
+
+typedef struct {
+    long long rows;
+    long long grades;
+    long long out_of_range;
+    long long malformed;
+} NumericStats;
+
+// Called once per row; count is the number of accepted grades
+typedef void (*NumericRowFn)(void *context, const char *name, size_t name_length,
+                             float average, int count, int rejected);
+
+int parseGrade(const char *text, const char **end, float *value);
+float averageGrades(const float *grades, int count);
+void numericDefaults(NumericOptions *options);
+void numericBatch(const char *text, size_t length, const NumericOptions *options,
+                  NumericRowFn on_row, void *context, NumericStats *stats);
+
+#endif
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_numeric.h"
+#include "gpa_roster_gen.h"
+#include "gpa_timer.h"
+
+// Batch averages for numeric grade sheets, the headless counterpart of
+// the simple calculator. Writes "name,average,count,rejected" per row to
+// stdout and a JSON summary to stderr.
+
+typedef struct {
+    FILE *out;
+    char delimiter;
+} Output;
+
+static void writeRow(void *context, const char *name, size_t name_length,
+                     float average, int count, int rejected) {
+    Output *output = context;
+    fwrite(name, 1, name_length, output->out);
+    fprintf(output->out, "%c%.2f%c%d%c%d\n", output->delimiter, average, output->delimiter, count,
+            output->delimiter, rejected);
+}
+
+// Read a whole file into a NUL-terminated buffer
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    size_t capacity = 1 << 20;
+    size_t used = 0;
+    char *data;
+
+    if (file == NULL) return NULL;
+    data = malloc(capacity + 1);
+    while (data != NULL) {
+        size_t n = fread(data + used, 1, capacity - used, file);
+        used += n;
+        if (used < capacity) break;
+        capacity *= 2;
+        char *grown = realloc(data, capacity + 1);
+        if (grown == NULL) free(data);
+        data = grown;
+    }
+    if (file != stdin) fclose(file);
+    if (data == NULL) return NULL;
+
+    data[used] = '\0';
+    *length = used;
+    return data;
+}
+
+// Synthetic grade sheet: about 1 in 50 grades is out of range
+static void generateSheet(FILE *out, int rows, int min_grades, int max_grades, unsigned long long seed) {
+    RosterGenOptions options;
+    RosterGen gen;
+    Student student;
+
+    rosterGenDefaults(&options);
+    options.seed = seed;
+    options.minCourses = options.maxCourses = 0;
+    rosterGenInit(&gen, &options);
+
+    for (int i = 0; i < rows; i++) {
+        rosterGenStudent(&gen, &student);
+        int count = min_grades + (int)(rosterGenRandom(&gen) % (unsigned int)(max_grades - min_grades + 1));
+        fputs(student.name, out);
+        for (int j = 0; j < count; j++) {
+            unsigned int r = rosterGenRandom(&gen);
+            int tenths = r % 50 == 0 ? 1005 + (int)(r % 200) : 400 + (int)(r % 601);
+            fprintf(out, ",%d.%d", tenths / 10, tenths % 10);
+        }
+        fputc('\n', out);
+    }
+}
+
+// A whole argument that parses as a grade, or 0
+static int parseBound(const char *text, float *bound) {
+    const char *end;
+    return parseGrade(text, &end, bound) && *end == '\0';
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--min X] [--max X] [--delimiter C] [--quiet] SHEET...\n"
+            "       %s --generate ROWS [--grades MIN-MAX] [--seed N] > SHEET\n"
+            "  --min, --max    valid grade range (default 0-100)\n"
+            "  --quiet         print only the summary\n"
+            "  SHEET may be '-' for standard input\n",
+            program, program);
+}
+
+int main(int argc, char **argv) {
+    NumericOptions options;
+    int quiet = 0;
+    int generate = 0;
+    int min_grades = 5, max_grades = 10;
+    unsigned long long seed = 1;
+    int first_file = argc;
+
+    numericDefaults(&options);
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--min") == 0 && value != NULL) {
+            if (!parseBound(value, &options.min_grade)) {
+                usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--max") == 0 && value != NULL) {
+            if (!parseBound(value, &options.max_grade)) {
+                usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--delimiter") == 0 && value != NULL) {
+            options.delimiter = strcmp(value, "\\t") == 0 ? '\t' : value[0];
+            i++;
+        } else if (strcmp(argv[i], "--generate") == 0 && value != NULL) {
+            generate = atoi(value);
+            i++;
+        } else if (strcmp(argv[i], "--grades") == 0 && value != NULL) {
+            if (sscanf(value, "%d-%d", &min_grades, &max_grades) != 2 || min_grades < 0 || min_grades > max_grades) {
+                usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            seed = strtoull(value, NULL, 10);
+            i++;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+
+    if (generate > 0) {
+        generateSheet(stdout, generate, min_grades, max_grades, seed);
+        return 0;
+    }
+    if (first_file == argc || options.min_grade > options.max_grade) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Output output = {stdout, options.delimiter};
+    NumericStats totals = {0, 0, 0, 0};
+    long long parse_ns = 0;
+    size_t bytes = 0;
+
+    for (int i = first_file; i < argc; i++) {
+        NumericStats stats;
+        size_t length;
+        char *text = readFile(argv[i], &length);
+        if (text == NULL) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            return 1;
+        }
+
+        long long start = nowNanoseconds();
+        numericBatch(text, length, &options, quiet ? NULL : writeRow, &output, &stats);
+        parse_ns += nowNanoseconds() - start;
+
+        totals.rows += stats.rows;
+        totals.grades += stats.grades;
+        totals.out_of_range += stats.out_of_range;
+        totals.malformed += stats.malformed;
+        bytes += length;
+        free(text);
+    }
+
+    fprintf(stderr, "{\"rows\":%lld,\"grades\":%lld,\"out_of_range\":%lld,\"malformed\":%lld,"
+            "\"ms\":%.3f,\"rows_per_sec\":%.0f,\"mb_per_sec\":%.1f}\n",
+            totals.rows, totals.grades, totals.out_of_range, totals.malformed, parse_ns / 1e6,
+            parse_ns > 0 ? totals.rows * 1e9 / parse_ns : 0.0,
+            parse_ns > 0 ? bytes * 1e3 / parse_ns : 0.0);
+    return 0;
+}
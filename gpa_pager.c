@@ -0,0 +1,287 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_pager.h"
+
+typedef struct {
+    const char *name;
+    float gpa;
+    int index;
+} SortKey;
+
+static int compareNoCase(const char *a, const char *b) {
+    while (*a != '\0' && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return tolower((unsigned char)*a) - tolower((unsigned char)*b);
+}
+
+// Case-insensitive prefix comparison, for seeking
+static int comparePrefixNoCase(const char *name, const char *prefix) {
+    while (*prefix != '\0') {
+        int diff = tolower((unsigned char)*name) - tolower((unsigned char)*prefix);
+        if (diff != 0) return diff;
+        name++;
+        prefix++;
+    }
+    return 0;
+}
+
+static int containsNoCase(const char *text, const char *lowerNeedle) {
+    size_t length = strlen(lowerNeedle);
+    for (; *text != '\0'; text++) {
+        size_t i = 0;
+        while (i < length && tolower((unsigned char)text[i]) == lowerNeedle[i]) i++;
+        if (i == length) return 1;
+    }
+    return length == 0;
+}
+
+// Ties keep source order so the listing is stable
+static int compareName(const void *a, const void *b) {
+    const SortKey *x = a, *y = b;
+    int diff = compareNoCase(x->name, y->name);
+    return diff != 0 ? diff : x->index - y->index;
+}
+
+static int compareGPADesc(const void *a, const void *b) {
+    const SortKey *x = a, *y = b;
+    if (x->gpa != y->gpa) return x->gpa < y->gpa ? 1 : -1;
+    return x->index - y->index;
+}
+
+static int compareGPAAsc(const void *a, const void *b) {
+    const SortKey *x = a, *y = b;
+    if (x->gpa != y->gpa) return x->gpa < y->gpa ? -1 : 1;
+    return x->index - y->index;
+}
+
+int pagerInit(Pager *pager, const PagerSource *source, int pageSize) {
+    memset(pager, 0, sizeof(*pager));
+    pager->source = *source;
+    pager->pageSize = pageSize;
+    pager->minGPA = -1.0f;
+    pager->maxGPA = 5.0f;
+    pager->rows = malloc(sizeof(*pager->rows) * pageSize);
+    if (pager->rows == NULL || !pagerRefresh(pager)) {
+        pagerFree(pager);
+        return 0;
+    }
+    return 1;
+}
+
+void pagerFree(Pager *pager) {
+    free(pager->order);
+    free(pager->rows);
+    pager->order = NULL;
+    pager->rows = NULL;
+    pager->orderCapacity = 0;
+}
+
+// Follow a source whose rows moved or grew
+int pagerSetSource(Pager *pager, const PagerSource *source) {
+    PagerSource previous = pager->source;
+
+    pager->source = *source;
+    if (pagerRefresh(pager)) return 1;
+    pager->source = previous;
+    return 0;
+}
+
+int pagerSetSort(Pager *pager, PagerSort sort) {
+    PagerSort previous = pager->sort;
+
+    pager->sort = sort;
+    if (pagerRefresh(pager)) return 1;
+    pager->sort = previous;
+    return 0;
+}
+
+// Empty or NULL name filter matches every row
+int pagerSetFilter(Pager *pager, const char *nameFilter, float minGPA, float maxGPA) {
+    char previousFilter[NAME_LENGTH];
+    float previousMin = pager->minGPA, previousMax = pager->maxGPA;
+    size_t i;
+
+    strcpy(previousFilter, pager->nameFilter);
+    pager->nameFilter[0] = '\0';
+    if (nameFilter != NULL) {
+        for (i = 0; nameFilter[i] != '\0' && i < NAME_LENGTH - 1; i++) {
+            pager->nameFilter[i] = (char)tolower((unsigned char)nameFilter[i]);
+        }
+        pager->nameFilter[i] = '\0';
+    }
+    pager->minGPA = minGPA;
+    pager->maxGPA = maxGPA;
+    if (pagerRefresh(pager)) return 1;
+    strcpy(pager->nameFilter, previousFilter);
+    pager->minGPA = previousMin;
+    pager->maxGPA = previousMax;
+    return 0;
+}
+
+// Rebuild the filtered, sorted index after the rows or settings changed;
+// re-reads source.count. Everything is allocated before the old order is
+// touched, so a failure keeps it.
+int pagerRefresh(Pager *pager) {
+    const PagerSource *source = &pager->source;
+    SortKey *keys = NULL;
+    int *order = pager->order;
+    int count = 0;
+    int i;
+
+    if (source->count > pager->orderCapacity) {
+        order = malloc(sizeof(int) * source->count);
+        if (order == NULL) return 0;
+    }
+    if (pager->sort != PAGER_SORT_NONE) {
+        keys = malloc(sizeof(SortKey) * (source->count > 0 ? source->count : 1));
+        if (keys == NULL) {
+            if (order != pager->order) free(order);
+            return 0;
+        }
+    }
+    if (order != pager->order) {
+        free(pager->order);
+        pager->order = order;
+        pager->orderCapacity = source->count;
+    }
+
+    for (i = 0; i < source->count; i++) {
+        const char *name = source->nameAt(source->context, i);
+        float gpa = source->gpaAt(source->context, i);
+
+        if (gpa < pager->minGPA || gpa > pager->maxGPA) continue;
+        if (pager->nameFilter[0] != '\0' && !containsNoCase(name, pager->nameFilter)) continue;
+
+        if (keys != NULL) {
+            keys[count].name = name;
+            keys[count].gpa = gpa;
+            keys[count].index = i;
+        } else {
+            pager->order[count] = i;
+        }
+        count++;
+    }
+
+    if (keys != NULL) {
+        switch (pager->sort) {
+            case PAGER_SORT_NAME: qsort(keys, count, sizeof(SortKey), compareName); break;
+            case PAGER_SORT_GPA_DESC: qsort(keys, count, sizeof(SortKey), compareGPADesc); break;
+            case PAGER_SORT_GPA_ASC: qsort(keys, count, sizeof(SortKey), compareGPAAsc); break;
+            default: break;
+        }
+        for (i = 0; i < count; i++) {
+            pager->order[i] = keys[i].index;
+        }
+        free(keys);
+    }
+
+    pager->count = count;
+    pagerScrollTo(pager, pager->top);
+    return 1;
+}
+
+// Make position the first visible row and format the window; returns the clamped top
+int pagerScrollTo(Pager *pager, int position) {
+    int maxTop = pager->count > pager->pageSize ? pager->count - pager->pageSize : 0;
+    int i;
+
+    if (position < 0) position = 0;
+    if (position > maxTop) position = maxTop;
+
+    pager->top = position;
+    pager->rowCount = pager->count - position < pager->pageSize ? pager->count - position : pager->pageSize;
+    for (i = 0; i < pager->rowCount; i++) {
+        pager->source.formatRow(pager->source.context, pager->order[position + i],
+                                pager->rows[i], LIST_ROW_LENGTH);
+    }
+    return position;
+}
+
+// First position whose name starts at or after name (name sort only), else -1
+int pagerSeekName(const Pager *pager, const char *name) {
+    int low = 0, high = pager->count;
+
+    if (pager->sort != PAGER_SORT_NAME) return -1;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const char *midName = pager->source.nameAt(pager->source.context, pager->order[mid]);
+        if (comparePrefixNoCase(midName, name) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// First position at or past gpa in the current GPA order, else -1
+int pagerSeekGPA(const Pager *pager, float gpa) {
+    int low = 0, high = pager->count;
+
+    if (pager->sort != PAGER_SORT_GPA_DESC && pager->sort != PAGER_SORT_GPA_ASC) return -1;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        float midGPA = pager->source.gpaAt(pager->source.context, pager->order[mid]);
+        int before = pager->sort == PAGER_SORT_GPA_DESC ? midGPA > gpa : midGPA < gpa;
+        if (before) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Source index shown at a display position, e.g. to switch to a selected student
+int pagerSourceIndex(const Pager *pager, int position) {
+    if (position < 0 || position >= pager->count) return -1;
+    return pager->order[position];
+}
+
+static const char *studentName(void *context, int index) {
+    return ((Student *)context)[index].name;
+}
+
+static float studentGPA(void *context, int index) {
+    return ((Student *)context)[index].gpa;
+}
+
+static int studentRow(void *context, int index, char *buf, size_t size) {
+    return formatStudentEntry(buf, size, &((Student *)context)[index]);
+}
+
+static const char *courseName(void *context, int index) {
+    return ((Student *)context)->courses[index].name;
+}
+
+static float courseGradePoints(void *context, int index) {
+    return letterGradeToPoints(((Student *)context)->courses[index].letterGrade);
+}
+
+static int courseRow(void *context, int index, char *buf, size_t size) {
+    return formatCourseEntry(buf, size, &((Student *)context)->courses[index]);
+}
+
+PagerSource pagerStudentSource(Student *students, int count) {
+    PagerSource source;
+    source.context = students;
+    source.count = count;
+    source.nameAt = studentName;
+    source.gpaAt = studentGPA;
+    source.formatRow = studentRow;
+    return source;
+}
+
+// Courses of one student; the "GPA" of a course row is its grade points
+PagerSource pagerCourseSource(Student *student) {
+    PagerSource source;
+    source.context = student;
+    source.count = student->courseCount;
+    source.nameAt = courseName;
+    source.gpaAt = courseGradePoints;
+    source.formatRow = courseRow;
+    return source;
+}
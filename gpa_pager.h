@@ -0,0 +1,64 @@
+#ifndef GPA_PAGER_H
+#define GPA_PAGER_H
+
+#include "gpa_core.h"
+#include "gpa_viewmodel.h"
+
+// Virtualized list data source. The pager keeps a filtered, sorted index
+// over a row source and formats only the rows of the visible window, so a
+// list of a million students costs one page of strings, not a million.
+
+// Where the rows come from; name and GPA drive filtering and sorting.
+// The pager keeps its own copy: when the rows grow, hand it the new count
+// with pagerSetSource.
+typedef struct {
+    void *context;
+    int count;
+    const char *(*nameAt)(void *context, int index);
+    float (*gpaAt)(void *context, int index);
+    int (*formatRow)(void *context, int index, char *buf, size_t size);
+} PagerSource;
+
+typedef enum {
+    PAGER_SORT_NONE,        // Source order
+    PAGER_SORT_NAME,        // A to Z
+    PAGER_SORT_GPA_DESC,    // Highest GPA first
+    PAGER_SORT_GPA_ASC
+} PagerSort;
+
+typedef struct {
+    PagerSource source;
+    PagerSort sort;
+
+    // Filter: case-insensitive name substring and a GPA range
+    char nameFilter[NAME_LENGTH];
+    float minGPA, maxGPA;
+
+    int *order;                  // Source indices of the visible rows, in display order
+    int count, orderCapacity;
+
+    // Visible window
+    int top;
+    int pageSize;
+    char (*rows)[LIST_ROW_LENGTH];
+    int rowCount;
+} Pager;
+
+// The setters and pagerRefresh rebuild the index and return 0 when out of
+// memory, leaving the previous settings and order in place
+int pagerInit(Pager *pager, const PagerSource *source, int pageSize);
+void pagerFree(Pager *pager);
+int pagerSetSource(Pager *pager, const PagerSource *source);
+int pagerSetSort(Pager *pager, PagerSort sort);
+int pagerSetFilter(Pager *pager, const char *nameFilter, float minGPA, float maxGPA);
+int pagerRefresh(Pager *pager);
+int pagerScrollTo(Pager *pager, int position);
+int pagerSeekName(const Pager *pager, const char *name);
+int pagerSeekGPA(const Pager *pager, float gpa);
+int pagerSourceIndex(const Pager *pager, int position);
+
+// Sources over Student arrays
+PagerSource pagerStudentSource(Student *students, int count);
+PagerSource pagerCourseSource(Student *student);
+
+#endif
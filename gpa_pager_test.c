@@ -0,0 +1,226 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_check.h"
+#include "gpa_pager.h"
+#include "gpa_roster_gen.h"
+
+// Headless checks of the pager against plain reference code: every sort
+// order against qsort, the filters against a linear scan, scroll clamping,
+// seeks, and following a roster that grows. Prints each failed check and
+// exits with status 1 if any failed.
+
+#define STUDENTS 5000
+#define PAGE_SIZE 20
+
+// Reference ordering: the same keys as the pager, ties in source order
+static const Student *referenceStudents;
+static PagerSort referenceSort;
+
+static int compareNoCase(const char *a, const char *b) {
+    while (*a != '\0' && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return tolower((unsigned char)*a) - tolower((unsigned char)*b);
+}
+
+static int startsWithNoCase(const char *name, const char *prefix) {
+    for (; *prefix != '\0'; name++, prefix++) {
+        if (tolower((unsigned char)*name) != tolower((unsigned char)*prefix)) return 0;
+    }
+    return 1;
+}
+
+static int containsNoCase(const char *text, const char *needle) {
+    for (; *text != '\0'; text++) {
+        if (startsWithNoCase(text, needle)) return 1;
+    }
+    return needle[0] == '\0';
+}
+
+static int compareReference(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    float gx = referenceStudents[x].gpa, gy = referenceStudents[y].gpa;
+    int diff = 0;
+
+    switch (referenceSort) {
+        case PAGER_SORT_NAME: diff = compareNoCase(referenceStudents[x].name, referenceStudents[y].name); break;
+        case PAGER_SORT_GPA_DESC: diff = (gx < gy) - (gx > gy); break;
+        case PAGER_SORT_GPA_ASC: diff = (gx > gy) - (gx < gy); break;
+        default: break;
+    }
+    return diff != 0 ? diff : x - y;
+}
+
+// Source indices the pager should list, in order
+static int referenceOrder(const Student *students, int count, PagerSort sort, const char *filter, float minGPA,
+                          float maxGPA, int *order) {
+    int matched = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (students[i].gpa < minGPA || students[i].gpa > maxGPA) continue;
+        if (filter != NULL && !containsNoCase(students[i].name, filter)) continue;
+        order[matched++] = i;
+    }
+    referenceStudents = students;
+    referenceSort = sort;
+    if (sort != PAGER_SORT_NONE) qsort(order, matched, sizeof(int), compareReference);
+    return matched;
+}
+
+static void checkOrder(const char *what, const Pager *pager, const int *expected, int count) {
+    if (!CHECK_COUNT(what, pager->count, count)) return;
+    for (int i = 0; i < count; i++) {
+        if (!CHECK_COUNT(what, pagerSourceIndex(pager, i), expected[i])) return;
+    }
+}
+
+static void checkSortsAndFilters(Student *students, int count, int *expected) {
+    static const PagerSort sorts[] = {PAGER_SORT_NONE, PAGER_SORT_NAME, PAGER_SORT_GPA_DESC, PAGER_SORT_GPA_ASC};
+    static const char *const filters[] = {NULL, "a", "ZU", "no such name"};
+    PagerSource source = pagerStudentSource(students, count);
+    Pager pager;
+
+    if (!pagerInit(&pager, &source, PAGE_SIZE)) return;
+    for (int s = 0; s < 4; s++) {
+        CHECK_COUNT("pagerSetSort", pagerSetSort(&pager, sorts[s]), 1);
+        for (int f = 0; f < 4; f++) {
+            float minGPA = f % 2 == 0 ? -1.0f : 2.0f;
+            float maxGPA = f % 2 == 0 ? 5.0f : 3.3f;
+            CHECK_COUNT("pagerSetFilter", pagerSetFilter(&pager, filters[f], minGPA, maxGPA), 1);
+            int matched = referenceOrder(students, count, sorts[s], filters[f], minGPA, maxGPA, expected);
+            checkOrder("sorted, filtered position", &pager, expected, matched);
+        }
+    }
+    CHECK_COUNT("pagerSourceIndex before the start", pagerSourceIndex(&pager, -1), -1);
+    CHECK_COUNT("pagerSourceIndex past the end", pagerSourceIndex(&pager, pager.count), -1);
+    pagerFree(&pager);
+}
+
+// The window clamps to the list and holds the formatted rows of its positions
+static void checkScroll(Student *students, int count, int *expected) {
+    PagerSource source = pagerStudentSource(students, count);
+    Pager pager;
+    char row[LIST_ROW_LENGTH];
+
+    if (!pagerInit(&pager, &source, PAGE_SIZE) || !pagerSetSort(&pager, PAGER_SORT_GPA_DESC)) return;
+    referenceOrder(students, count, PAGER_SORT_GPA_DESC, NULL, -1.0f, 5.0f, expected);
+    int last = count - PAGE_SIZE;
+    int targets[][2] = {{0, 0}, {-5, 0}, {last, last}, {last + 1, last}, {count * 2, last}, {1234, 1234}};
+    for (int t = 0; t < 6; t++) {
+        CHECK_COUNT("pagerScrollTo result", pagerScrollTo(&pager, targets[t][0]), targets[t][1]);
+        CHECK_COUNT("top", pager.top, targets[t][1]);
+        CHECK_COUNT("rows in the window", pager.rowCount, PAGE_SIZE);
+        for (int i = 0; i < pager.rowCount; i++) {
+            formatStudentEntry(row, sizeof(row), &students[expected[pager.top + i]]);
+            CHECK_COUNT("window row matches", strcmp(pager.rows[i], row), 0);
+        }
+    }
+
+    // A list shorter than a page shows all of it from the top
+    CHECK_COUNT("pagerSetFilter", pagerSetFilter(&pager, students[0].name, -1.0f, 5.0f), 1);
+    int shortCount = referenceOrder(students, count, PAGER_SORT_GPA_DESC, students[0].name, -1.0f, 5.0f, expected);
+    CHECK_COUNT("short list fits a page", shortCount < PAGE_SIZE && shortCount > 0, 1);
+    CHECK_COUNT("short list scroll", pagerScrollTo(&pager, 3), 0);
+    CHECK_COUNT("short list rows", pager.rowCount, shortCount);
+    pagerFree(&pager);
+}
+
+// A seek lands on the first position at or after the key
+static void checkSeeks(Student *students, int count, int *expected) {
+    static const char *const prefixes[] = {"", "a", "Ka", "m", "zz", "{", "Zuluvugez"};
+    static const float gpas[] = {-1.0f, 0.0f, 1.7f, 2.0f, 2.85f, 3.3f, 4.0f, 4.5f};
+    PagerSource source = pagerStudentSource(students, count);
+    Pager pager;
+
+    if (!pagerInit(&pager, &source, PAGE_SIZE)) return;
+    CHECK_COUNT("seek name without name sort", pagerSeekName(&pager, "a"), -1);
+    CHECK_COUNT("seek GPA without GPA sort", pagerSeekGPA(&pager, 3.0f), -1);
+
+    pagerSetSort(&pager, PAGER_SORT_NAME);
+    referenceOrder(students, count, PAGER_SORT_NAME, NULL, -1.0f, 5.0f, expected);
+    for (int p = 0; p < 7; p++) {
+        int position = 0;
+        while (position < count && compareNoCase(students[expected[position]].name, prefixes[p]) < 0 &&
+               !startsWithNoCase(students[expected[position]].name, prefixes[p])) {
+            position++;
+        }
+        CHECK_COUNT("pagerSeekName", pagerSeekName(&pager, prefixes[p]), position);
+    }
+
+    for (int sort = PAGER_SORT_GPA_DESC; sort <= PAGER_SORT_GPA_ASC; sort++) {
+        pagerSetSort(&pager, (PagerSort)sort);
+        referenceOrder(students, count, (PagerSort)sort, NULL, -1.0f, 5.0f, expected);
+        for (int g = 0; g < 8; g++) {
+            int position = 0;
+            while (position < count && (sort == PAGER_SORT_GPA_DESC ? students[expected[position]].gpa > gpas[g]
+                                                                     : students[expected[position]].gpa < gpas[g])) {
+                position++;
+            }
+            CHECK_COUNT("pagerSeekGPA", pagerSeekGPA(&pager, gpas[g]), position);
+        }
+    }
+    pagerFree(&pager);
+
+    // Empty source: nothing to show, every seek lands on 0
+    source = pagerStudentSource(students, 0);
+    if (!pagerInit(&pager, &source, PAGE_SIZE)) return;
+    CHECK_COUNT("empty count", pager.count, 0);
+    CHECK_COUNT("empty scroll", pagerScrollTo(&pager, 10), 0);
+    CHECK_COUNT("empty rows", pager.rowCount, 0);
+    pagerSetSort(&pager, PAGER_SORT_NAME);
+    CHECK_COUNT("empty seek name", pagerSeekName(&pager, "a"), 0);
+    pagerSetSort(&pager, PAGER_SORT_GPA_ASC);
+    CHECK_COUNT("empty seek GPA", pagerSeekGPA(&pager, 2.0f), 0);
+    pagerFree(&pager);
+}
+
+// Rows added after init show up once the pager is given the new count
+static void checkGrowth(Student *students, int count, int *expected) {
+    PagerSource source = pagerStudentSource(students, count / 10);
+    Pager pager;
+
+    if (!pagerInit(&pager, &source, PAGE_SIZE) || !pagerSetSort(&pager, PAGER_SORT_NAME)) return;
+    CHECK_COUNT("count before growth", pager.count, count / 10);
+    source = pagerStudentSource(students, count);
+    CHECK_COUNT("pagerSetSource", pagerSetSource(&pager, &source), 1);
+    int matched = referenceOrder(students, count, PAGER_SORT_NAME, NULL, -1.0f, 5.0f, expected);
+    checkOrder("position after growth", &pager, expected, matched);
+    pagerFree(&pager);
+}
+
+int main(void) {
+    RosterGenOptions options;
+    RosterGen gen;
+    Student *students = malloc(sizeof(Student) * STUDENTS);
+    int *expected = malloc(sizeof(int) * STUDENTS);
+
+    if (students == NULL || expected == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    rosterGenDefaults(&options);
+    rosterGenInit(&gen, &options);
+    rosterGenFill(&gen, students, STUDENTS);
+    for (int i = 0; i < STUDENTS; i++) {
+        // Repeated names, names differing only in case, and GPA ties
+        if (i % 50 == 7) strcpy(students[i].name, students[i - 7].name);
+        if (i % 50 == 8) {
+            strcpy(students[i].name, students[i - 8].name);
+            students[i].name[0] = (char)tolower((unsigned char)students[i].name[0]);
+        }
+        computeStudentGPA(&students[i], NULL);
+        if (i % 25 == 3) students[i].gpa = 3.0f;
+    }
+
+    checkSortsAndFilters(students, STUDENTS, expected);
+    checkScroll(students, STUDENTS, expected);
+    checkSeeks(students, STUDENTS, expected);
+    checkGrowth(students, STUDENTS, expected);
+
+    free(expected);
+    free(students);
+    return checkReport("pager");
+}
@@ -0,0 +1,343 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_rank.h"
+#include "gpa_timer.h"
+
+// Entries each merge input buffers at minimum
+#define MERGE_CHUNK_MIN 64
+
+// Names tried for a run file in tempDir before giving up
+#define RUN_NAME_ATTEMPTS 16
+
+typedef struct {
+    unsigned long long key;
+    unsigned int id;
+    int index;
+} SortItem;
+
+typedef struct {
+    FILE *file;
+    long long remaining;    // Entries still in the file
+    RankEntry *buffer;
+    int count, pos;
+    unsigned long long key; // Key of buffer[pos]
+} MergeInput;
+
+// GPA descending, then credits descending, as one ascending integer
+static unsigned long long rankKey(const RankEntry *entry) {
+    float gpa = entry->gpa > 0.0f ? entry->gpa : 0.0f;
+    unsigned int bits;
+    unsigned int credits = entry->credits > 0 ? (unsigned int)entry->credits : 0;
+
+    memcpy(&bits, &gpa, sizeof(bits));
+    return (unsigned long long)(0xFFFFFFFFu - bits) << 32 | (0xFFFFFFFFu - credits);
+}
+
+static int compareItems(const void *a, const void *b) {
+    const SortItem *x = a, *y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+void rankDefaults(RankOptions *options) {
+    options->memoryBudget = 64 * 1024 * 1024;
+    options->tempDir = NULL;
+}
+
+int rankInit(RankSorter *sorter, const RankOptions *options) {
+    size_t budget = options->memoryBudget > RANK_MIN_MEMORY ? options->memoryBudget : RANK_MIN_MEMORY;
+
+    memset(sorter, 0, sizeof(*sorter));
+    sorter->options = *options;
+    sorter->options.memoryBudget = budget;
+    sorter->capacity = (int)(budget / (sizeof(RankEntry) + sizeof(SortItem)));
+    sorter->buffer = malloc(sizeof(RankEntry) * sorter->capacity);
+    sorter->sortItems = malloc(sizeof(SortItem) * sorter->capacity);
+    if (sorter->buffer == NULL || sorter->sortItems == NULL) {
+        rankFree(sorter);
+        return 0;
+    }
+    return 1;
+}
+
+static RankRun *openRun(RankSorter *sorter) {
+    RankRun *run;
+
+    if (sorter->runCount == sorter->runCapacity) {
+        int capacity = sorter->runCapacity > 0 ? sorter->runCapacity * 2 : 16;
+        RankRun *grown = realloc(sorter->runs, sizeof(RankRun) * capacity);
+        if (grown == NULL) return NULL;
+        sorter->runs = grown;
+        sorter->runCapacity = capacity;
+    }
+
+    run = &sorter->runs[sorter->runCount];
+    run->count = 0;
+    run->path[0] = '\0';
+    run->file = NULL;
+    if (sorter->options.tempDir != NULL) {
+        int attempt;
+
+        // Exclusive create ("x"): never open a file someone else put there
+        for (attempt = 0; attempt < RUN_NAME_ATTEMPTS && run->file == NULL; attempt++) {
+            snprintf(run->path, sizeof(run->path), "%s/gpa_rank_%lld_%d.run", sorter->options.tempDir,
+                     nowNanoseconds(), sorter->nextRunId++);
+            run->file = fopen(run->path, "w+bx");
+        }
+        if (run->file == NULL) run->path[0] = '\0';
+    } else {
+        run->file = tmpfile();
+    }
+    if (run->file == NULL) return NULL;
+    sorter->runCount++;
+    return run;
+}
+
+static void closeRun(RankRun *run) {
+    if (run->file != NULL) fclose(run->file);
+    if (run->path[0] != '\0') remove(run->path);
+    run->file = NULL;
+}
+
+// Sort the buffered entries by rank order; returns the sorted items
+static SortItem *sortBuffer(RankSorter *sorter) {
+    SortItem *items = sorter->sortItems;
+    int i;
+
+    for (i = 0; i < sorter->count; i++) {
+        items[i].key = rankKey(&sorter->buffer[i]);
+        items[i].id = sorter->buffer[i].id;
+        items[i].index = i;
+    }
+    qsort(items, sorter->count, sizeof(SortItem), compareItems);
+    return items;
+}
+
+// Write the buffer out as one sorted run
+static int spill(RankSorter *sorter) {
+    SortItem *items;
+    RankRun *run;
+    int i;
+
+    if (sorter->count == 0) return 1;
+    items = sortBuffer(sorter);
+    run = openRun(sorter);
+    if (run == NULL) return 0;
+    for (i = 0; i < sorter->count; i++) {
+        if (fwrite(&sorter->buffer[items[i].index], sizeof(RankEntry), 1, run->file) != 1) return 0;
+    }
+    if (fflush(run->file) != 0) return 0;
+    run->count = sorter->count;
+    sorter->spilledRuns++;
+    sorter->spilledBytes += (long long)sorter->count * sizeof(RankEntry);
+    sorter->count = 0;
+    return 1;
+}
+
+// Entries are copied field by field into a zeroed slot, so run files never
+// carry padding or whatever the caller left after the name's terminator
+int rankAdd(RankSorter *sorter, const RankEntry *entry) {
+    RankEntry *slot;
+
+    if (sorter->count == sorter->capacity && !spill(sorter)) return 0;
+    slot = &sorter->buffer[sorter->count++];
+    memset(slot, 0, sizeof(*slot));
+    slot->gpa = entry->gpa;
+    slot->credits = entry->credits;
+    slot->id = entry->id;
+    snprintf(slot->name, sizeof(slot->name), "%s", entry->name);
+    sorter->entries++;
+    return 1;
+}
+
+int rankAddStudent(RankSorter *sorter, unsigned int id, const Student *student) {
+    RankEntry entry;
+    int credits = 0;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.gpa = weightedGPA(student, NULL, &credits);
+    entry.credits = credits;
+    entry.id = id;
+    snprintf(entry.name, sizeof(entry.name), "%s", student->name);
+    return rankAdd(sorter, &entry);
+}
+
+// Refill an input's buffer from its run; returns 0 when the run is exhausted
+static int fillInput(MergeInput *input, int chunk) {
+    size_t want = input->remaining < chunk ? (size_t)input->remaining : (size_t)chunk;
+
+    if (want == 0) return 0;
+    input->count = (int)fread(input->buffer, sizeof(RankEntry), want, input->file);
+    input->remaining -= input->count;
+    input->pos = 0;
+    if (input->count == 0) {
+        input->remaining = 0;
+        return 0;
+    }
+    input->key = rankKey(&input->buffer[0]);
+    return 1;
+}
+
+static int inputBefore(const MergeInput *a, const MergeInput *b) {
+    if (a->key != b->key) return a->key < b->key;
+    return a->buffer[a->pos].id < b->buffer[b->pos].id;
+}
+
+static void siftDown(MergeInput **heap, int size, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1, right = left + 1;
+        MergeInput *swap;
+
+        if (left < size && inputBefore(heap[left], heap[smallest])) smallest = left;
+        if (right < size && inputBefore(heap[right], heap[smallest])) smallest = right;
+        if (smallest == i) return;
+        swap = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = swap;
+        i = smallest;
+    }
+}
+
+// Tracks shared ranks while streaming the final order
+typedef struct {
+    RankOutputFn output;
+    void *context;
+    FILE *file;             // Intermediate run instead of output, when set
+    long long position;
+    long long rank;
+    unsigned long long lastKey;
+    int stopped;            // The output asked for no more entries
+} MergeSink;
+
+// Returns 0 on a write error
+static int emit(MergeSink *sink, const RankEntry *entry, unsigned long long key) {
+    if (sink->file != NULL) return fwrite(entry, sizeof(RankEntry), 1, sink->file) == 1;
+
+    sink->position++;
+    if (sink->position == 1 || key != sink->lastKey) sink->rank = sink->position;
+    sink->lastKey = key;
+    if (!sink->output(sink->context, sink->rank, entry)) sink->stopped = 1;
+    return 1;
+}
+
+// k-way merge of runs[first .. first+count) into sink; 0 on an I/O error
+static int mergeRuns(RankSorter *sorter, int first, int count, MergeSink *sink) {
+    int chunk = (int)(sorter->options.memoryBudget / ((size_t)(count + 1) * sizeof(RankEntry)));
+    MergeInput *inputs = calloc(count, sizeof(MergeInput));
+    MergeInput **heap = malloc(sizeof(MergeInput *) * count);
+    RankEntry *buffers = NULL;
+    int size = 0;
+    int ok = 1;
+    int i;
+
+    if (chunk < MERGE_CHUNK_MIN) chunk = MERGE_CHUNK_MIN;
+    if (inputs != NULL && heap != NULL) buffers = malloc(sizeof(RankEntry) * chunk * count);
+    if (buffers == NULL) {
+        free(inputs);
+        free(heap);
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        RankRun *run = &sorter->runs[first + i];
+        rewind(run->file);
+        inputs[i].file = run->file;
+        inputs[i].remaining = run->count;
+        inputs[i].buffer = buffers + (size_t)chunk * i;
+        if (fillInput(&inputs[i], chunk)) heap[size++] = &inputs[i];
+    }
+    for (i = size / 2 - 1; i >= 0; i--) siftDown(heap, size, i);
+
+    while (size > 0 && ok && !sink->stopped) {
+        MergeInput *top = heap[0];
+        ok = emit(sink, &top->buffer[top->pos], top->key);
+
+        if (++top->pos < top->count) {
+            top->key = rankKey(&top->buffer[top->pos]);
+        } else if (!fillInput(top, chunk)) {
+            heap[0] = heap[--size];
+        }
+        siftDown(heap, size, 0);
+    }
+    for (i = 0; i < count; i++) {
+        if (ferror(inputs[i].file)) ok = 0;
+    }
+
+    free(buffers);
+    free(heap);
+    free(inputs);
+    return ok;
+}
+
+// Merge the runs down to one pass and stream the ranked entries
+int rankFinish(RankSorter *sorter, RankOutputFn output, void *context) {
+    MergeSink sink;
+    int fanIn;
+    int i;
+
+    memset(&sink, 0, sizeof(sink));
+    sink.output = output;
+    sink.context = context;
+
+    // Everything fit: no disk at all
+    if (sorter->runCount == 0) {
+        SortItem *items = sortBuffer(sorter);
+        for (i = 0; i < sorter->count && !sink.stopped; i++) {
+            emit(&sink, &sorter->buffer[items[i].index], items[i].key);
+        }
+        return 1;
+    }
+
+    if (!spill(sorter)) return 0;
+
+    // The merge reuses the sort buffer's share of the budget
+    free(sorter->buffer);
+    free(sorter->sortItems);
+    sorter->buffer = NULL;
+    sorter->sortItems = NULL;
+    sorter->capacity = 0;
+
+    fanIn = (int)(sorter->options.memoryBudget / (sizeof(RankEntry) * MERGE_CHUNK_MIN)) - 1;
+    if (fanIn < 2) fanIn = 2;
+
+    // Too many runs for one merge: merge the oldest into a new run until they fit
+    while (sorter->runCount > fanIn) {
+        RankRun *merged = openRun(sorter);
+        MergeSink runSink;
+
+        if (merged == NULL) return 0;
+        memset(&runSink, 0, sizeof(runSink));
+        runSink.file = merged->file;
+        if (!mergeRuns(sorter, 0, fanIn, &runSink) || fflush(merged->file) != 0) return 0;
+
+        merged = &sorter->runs[sorter->runCount - 1];
+        for (i = 0; i < fanIn; i++) {
+            merged->count += sorter->runs[i].count;
+            closeRun(&sorter->runs[i]);
+        }
+        sorter->spilledBytes += merged->count * (long long)sizeof(RankEntry);
+        memmove(sorter->runs, sorter->runs + fanIn, sizeof(RankRun) * (sorter->runCount - fanIn));
+        sorter->runCount -= fanIn;
+        sorter->mergePasses++;
+    }
+
+    sorter->mergePasses++;
+    return mergeRuns(sorter, 0, sorter->runCount, &sink);
+}
+
+// Close and delete any runs and release the buffers
+void rankFree(RankSorter *sorter) {
+    int i;
+
+    for (i = 0; i < sorter->runCount; i++) closeRun(&sorter->runs[i]);
+    free(sorter->runs);
+    free(sorter->buffer);
+    free(sorter->sortItems);
+    sorter->runs = NULL;
+    sorter->buffer = NULL;
+    sorter->sortItems = NULL;
+    sorter->runCount = 0;
+    sorter->count = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef GPA_RANK_H
+#define GPA_RANK_H
+
+#include <stdio.h>
+#include "gpa_core.h"
+
+// Rankings over rosters larger than memory. Entries are collected into a
+// buffer bounded by the memory budget; each full buffer is sorted and
+// spilled to a temporary run file. rankFinish merges the runs with a k-way
+// heap (in several passes if there are more runs than the budget can
+// buffer) and streams the ranked entries to a callback. Rosters that fit
+// in the budget are sorted in memory and never touch the disk.
+//
+// Order: GPA descending, then credits descending, then id. Students with
+// the same GPA and credits share a rank (1, 2, 2, 4, ...).
+
+// Smallest budget accepted; below this the sorter uses this much anyway
+#define RANK_MIN_MEMORY (256 * 1024)
+
+typedef struct {
+    float gpa;
+    int credits;
+    unsigned int id;
+    char name[NAME_LENGTH];
+} RankEntry;
+
+typedef struct {
+    size_t memoryBudget;    // Bytes for the sort buffer and merge buffers
+    const char *tempDir;    // Where runs are spilled; NULL for the C library default
+} RankOptions;
+
+typedef struct {
+    FILE *file;
+    char path[260];         // Empty for tmpfile() runs
+    long long count;
+} RankRun;
+
+typedef struct {
+    RankOptions options;
+    RankEntry *buffer;
+    void *sortItems;
+    int capacity;
+    int count;
+
+    RankRun *runs;
+    int runCount, runCapacity;
+    int nextRunId;
+
+    long long entries;
+    int spilledRuns;            // Sorted runs written from the buffer
+    long long spilledBytes;     // Bytes written to runs, all passes
+    int mergePasses;
+} RankSorter;
+
+// Receives the entries in rank order; return 0 to stop early
+typedef int (*RankOutputFn)(void *context, long long rank, const RankEntry *entry);
+
+void rankDefaults(RankOptions *options);
+int rankInit(RankSorter *sorter, const RankOptions *options);
+int rankAdd(RankSorter *sorter, const RankEntry *entry);
+int rankAddStudent(RankSorter *sorter, unsigned int id, const Student *student);
+int rankFinish(RankSorter *sorter, RankOutputFn output, void *context);
+void rankFree(RankSorter *sorter);
+
+#endif
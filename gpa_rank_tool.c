@@ -0,0 +1,175 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "gpa_archive.h"
+#include "gpa_rank.h"
+#include "gpa_roster_gen.h"
+#include "gpa_timer.h"
+
+// Institution-wide ranking with bounded memory. Writes
+// "rank,id,name,gpa,credits" in rank order to stdout and a JSON summary
+// to stderr.
+
+typedef struct {
+    FILE *out;
+    long long top;          // Stop after this many rows; 0 for all
+    long long written;
+} RankOutput;
+
+static int writeRank(void *context, long long rank, const RankEntry *entry) {
+    RankOutput *output = context;
+    if (output->out != NULL) {
+        fprintf(output->out, "%lld,%u,%s,%.3f,%d\n", rank, entry->id, entry->name, entry->gpa, entry->credits);
+    }
+    output->written++;
+    return output->top == 0 || output->written < output->top;
+}
+
+// Archived records arrive grouped by student; one entry per student
+typedef struct {
+    RankSorter *sorter;
+    unsigned int student;
+    float points;
+    int credits;
+    int started;
+    int ok;
+} ArchiveRanking;
+
+static void addArchivedStudent(ArchiveRanking *ranking) {
+    RankEntry entry = {0};
+    if (!ranking->started) return;
+    entry.gpa = ranking->credits > 0 ? ranking->points / ranking->credits : 0.0f;
+    entry.credits = ranking->credits;
+    entry.id = ranking->student;
+    entry.name[0] = '\0';
+    if (!rankAdd(ranking->sorter, &entry)) ranking->ok = 0;
+}
+
+static void rankArchiveBlock(void *context, const ArchiveRecord *records, int count) {
+    ArchiveRanking *ranking = context;
+    for (int i = 0; i < count; i++) {
+        const ArchiveRecord *record = &records[i];
+        if (!ranking->started || record->studentId != ranking->student) {
+            addArchivedStudent(ranking);
+            ranking->student = record->studentId;
+            ranking->points = 0.0f;
+            ranking->credits = 0;
+            ranking->started = 1;
+        }
+        ranking->points += letterGradeToPoints(gradeLetters[record->grade]) * record->creditHours;
+        ranking->credits += record->creditHours;
+    }
+}
+
+// A whole argument that parses as a positive number of megabytes that
+// fits in a size_t, converted to bytes; 0 otherwise
+static int parseMegabytes(const char *text, size_t *bytes) {
+    char *end;
+    double megabytes = strtod(text, &end);
+
+    if (end == text || *end != '\0' || !(megabytes > 0) ||
+        megabytes >= (double)SIZE_MAX / (1024 * 1024)) {
+        return 0;
+    }
+    *bytes = (size_t)(megabytes * 1024 * 1024);
+    return *bytes > 0;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s (--generate STUDENTS [--seed N] | --archive FILE) [options]\n"
+            "  --memory MB   memory budget for sorting (default 64)\n"
+            "  --temp DIR    directory for spilled runs (default: system temp)\n"
+            "  --top N       stop after the first N ranks\n"
+            "  --quiet       print only the summary\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    RankOptions options;
+    RankSorter sorter;
+    RankOutput output = {stdout, 0, 0};
+    const char *archivePath = NULL;
+    int generate = 0;
+    unsigned long long seed = 1;
+
+    rankDefaults(&options);
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--generate") == 0 && value != NULL) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--archive") == 0 && value != NULL) {
+            archivePath = argv[++i];
+        } else if (strcmp(argv[i], "--memory") == 0 && value != NULL) {
+            if (!parseMegabytes(argv[++i], &options.memoryBudget)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--temp") == 0 && value != NULL) {
+            options.tempDir = argv[++i];
+        } else if (strcmp(argv[i], "--top") == 0 && value != NULL) {
+            output.top = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            output.out = NULL;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((archivePath == NULL) == (generate <= 0)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!rankInit(&sorter, &options)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    long long start = nowNanoseconds();
+    int ok = 1;
+    if (archivePath != NULL) {
+        Archive archive;
+        ArchiveRanking ranking = {&sorter, 0, 0.0f, 0, 0, 1};
+        if (!archiveLoad(&archive, archivePath)) {
+            fprintf(stderr, "Cannot load %s\n", archivePath);
+            return 1;
+        }
+        ok = archiveScan(&archive, rankArchiveBlock, &ranking);
+        addArchivedStudent(&ranking);
+        ok = ok && ranking.ok;
+        archiveFree(&archive);
+    } else {
+        // Streamed, so only the sorter's budget is ever resident
+        RosterGenOptions genOptions;
+        RosterGen gen;
+        Student student;
+        rosterGenDefaults(&genOptions);
+        genOptions.seed = seed;
+        rosterGenInit(&gen, &genOptions);
+        for (int i = 0; i < generate && ok; i++) {
+            rosterGenStudent(&gen, &student);
+            ok = rankAddStudent(&sorter, (unsigned int)i, &student);
+        }
+    }
+    long long collected = nowNanoseconds();
+
+    ok = ok && rankFinish(&sorter, writeRank, &output);
+    long long finished = nowNanoseconds();
+    if (!ok) {
+        fprintf(stderr, "Ranking failed: out of memory or temporary file error\n");
+        rankFree(&sorter);
+        return 1;
+    }
+
+    fprintf(stderr, "{\"entries\":%lld,\"written\":%lld,\"budget_mb\":%.1f,\"data_mb\":%.1f,\"runs\":%d,"
+            "\"merge_passes\":%d,\"spilled_mb\":%.1f,\"collect_ms\":%.1f,\"merge_ms\":%.1f}\n",
+            sorter.entries, output.written, sorter.options.memoryBudget / 1048576.0,
+            sorter.entries * (double)sizeof(RankEntry) / 1048576.0, sorter.spilledRuns, sorter.mergePasses,
+            sorter.spilledBytes / 1048576.0, (collected - start) / 1e6, (finished - collected) / 1e6);
+    rankFree(&sorter);
+    return 0;
+}
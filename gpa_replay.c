@@ -0,0 +1,188 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_replay.h"
+#include "gpa_timer.h"
+
+static const char *const commandNames[CMD_COUNT] = {
+    "none", "add_student", "add_course", "calculate_gpa", "clear_form", "switch_student", "selchange", "find"
+};
+
+const char *replayCommandName(int commandId) {
+    if (commandId < 0 || commandId >= CMD_COUNT) return "unknown";
+    return commandNames[commandId];
+}
+
+int replayInit(ReplaySession *session, int maxStudents) {
+    memset(session, 0, sizeof(*session));
+    session->students = malloc(sizeof(Student) * maxStudents);
+    if (session->students == NULL ||
+        !viewInit(&session->view, &countingViewOps, &session->viewUpdates, session->students, maxStudents)) {
+        free(session->students);
+        session->students = NULL;
+        return 0;
+    }
+    controllerInit(&session->controller, session->students, maxStudents, &session->view);
+    controllerClearForm(&session->form);
+    return 1;
+}
+
+void replayFree(ReplaySession *session) {
+    controllerFree(&session->controller);
+    viewFree(&session->view);
+    free(session->students);
+    session->students = NULL;
+}
+
+// Run one button press (or CMD_SELCHANGE) and do to the form what the
+// window does to its controls
+void replayCommand(ReplaySession *session, int commandId) {
+    ControllerForm *form = &session->form;
+    ControllerReply reply;
+
+    controllerCommand(&session->controller, commandId, form, &reply);
+    if (reply.severity != CONTROLLER_NO_MESSAGE) session->messageBoxes++;
+    if (reply.clearCourseForm) {
+        form->courseName[0] = '\0';
+        form->credits[0] = '\0';
+        form->grade = 0;
+    }
+    if (reply.clearStudentName) form->studentName[0] = '\0';
+    // The listbox selection follows the view
+    form->selection = session->view.selection;
+}
+
+static void addSample(ReplayLatency *latency, long long ns) {
+    if (latency->count == latency->capacity) {
+        int capacity = latency->capacity ? latency->capacity * 2 : 256;
+        long long *grown = realloc(latency->samples, sizeof(long long) * capacity);
+        if (grown == NULL) return;
+        latency->samples = grown;
+        latency->capacity = capacity;
+    }
+    latency->samples[latency->count++] = ns;
+    latency->totalNs += ns;
+}
+
+static void copyField(char *dest, size_t size, const char *value) {
+    size_t length = strcspn(value, "\r\n");
+    if (length >= size) length = size - 1;
+    memcpy(dest, value, length);
+    dest[length] = '\0';
+}
+
+// Apply one recorded line; returns 0 for a malformed line
+int replayLine(ReplaySession *session, const char *line, ReplayStats *stats) {
+    char key[16];
+    size_t keyLength = strcspn(line, " \r\n");
+    const char *value = line + keyLength;
+    int ok = 1;
+
+    if (stats != NULL) stats->lines++;
+    if (keyLength == 0 || line[0] == '#') return 1;
+    if (*value == ' ') value++;
+    copyField(key, keyLength < sizeof(key) ? keyLength + 1 : sizeof(key), line);
+
+    if (strcmp(key, "name") == 0) {
+        copyField(session->form.studentName, sizeof(session->form.studentName), value);
+    } else if (strcmp(key, "course") == 0) {
+        copyField(session->form.courseName, sizeof(session->form.courseName), value);
+    } else if (strcmp(key, "credits") == 0) {
+        copyField(session->form.credits, sizeof(session->form.credits), value);
+    } else if (strcmp(key, "find") == 0) {
+        copyField(session->form.find, sizeof(session->form.find), value);
+    } else if (strcmp(key, "grade") == 0) {
+        char letter[3];
+        int i;
+        copyField(letter, sizeof(letter), value);
+        for (i = 0; i < GRADE_COUNT; i++) {
+            if (strcmp(letter, gradeLetters[i]) == 0) break;
+        }
+        if (i < GRADE_COUNT) {
+            session->form.grade = i;
+        } else {
+            ok = 0;
+        }
+    } else if (strcmp(key, "select") == 0) {
+        int index = atoi(value);
+        session->form.selection = index >= 0 && index < session->controller.studentCount ? index : -1;
+    } else if (strcmp(key, "cmd") == 0 || strcmp(key, "selchange") == 0) {
+        int commandId = key[0] == 's' ? CMD_SELCHANGE : atoi(value);
+        if (commandId >= CMD_ADD_STUDENT && commandId < CMD_COUNT) {
+            long long start = nowNanoseconds();
+            replayCommand(session, commandId);
+            if (stats != NULL) addSample(&stats->commands[commandId], nowNanoseconds() - start);
+        } else {
+            ok = 0;
+        }
+    } else {
+        ok = 0;
+    }
+
+    if (!ok && stats != NULL) stats->badLines++;
+    return ok;
+}
+
+// Replay a whole recording; returns the number of malformed lines
+int replayFile(ReplaySession *session, FILE *file, ReplayStats *stats) {
+    char line[2 * NAME_LENGTH];
+    int bad = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (!replayLine(session, line, stats)) bad++;
+    }
+    return bad;
+}
+
+void replayStatsFree(ReplayStats *stats) {
+    int i;
+    for (i = 0; i < CMD_COUNT; i++) {
+        free(stats->commands[i].samples);
+        stats->commands[i].samples = NULL;
+        stats->commands[i].count = stats->commands[i].capacity = 0;
+    }
+}
+
+void recordField(FILE *file, const char *key, const char *value) {
+    fprintf(file, "%s %s\n", key, value);
+}
+
+void recordSelection(FILE *file, int index) {
+    fprintf(file, "select %d\n", index);
+}
+
+// Append the form contents a command reads, then the command itself
+void recordFormCommand(FILE *file, int commandId, const ControllerForm *form) {
+    switch (commandId) {
+        case CMD_ADD_STUDENT:
+            recordField(file, "name", form->studentName);
+            break;
+        case CMD_ADD_COURSE:
+            recordField(file, "course", form->courseName);
+            recordField(file, "credits", form->credits);
+            if (form->grade >= 0 && form->grade < GRADE_COUNT) recordField(file, "grade", gradeLetters[form->grade]);
+            break;
+        case CMD_SWITCH_STUDENT:
+        case CMD_SELCHANGE:
+            recordSelection(file, form->selection);
+            break;
+        case CMD_FIND:
+            recordField(file, "find", form->find);
+            break;
+        case CMD_CALCULATE_GPA:
+        case CMD_CLEAR_FORM:
+            break;
+        default:
+            return;
+    }
+    recordCommand(file, commandId);
+}
+
+void recordCommand(FILE *file, int commandId) {
+    if (commandId == CMD_SELCHANGE) {
+        fputs("selchange\n", file);
+    } else {
+        fprintf(file, "cmd %d\n", commandId);
+    }
+    fflush(file);
+}
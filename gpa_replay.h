@@ -0,0 +1,65 @@
+#ifndef GPA_REPLAY_H
+#define GPA_REPLAY_H
+
+#include <stdio.h>
+#include "gpa_controller.h"
+
+// Recorded UI sessions of the advanced calculator.
+//
+// A recording is a text file with one event per line:
+//   name <text>       Student Name edit contents
+//   course <text>     Course Name edit contents
+//   credits <text>    Credit Hours edit contents
+//   grade <letter>    Grade combo selection (A+ .. F)
+//   find <text>       Find edit contents
+//   select <index>    Student list selection
+//   cmd <id>          WM_COMMAND button id (1-5 and 7, see gpa_controller.h)
+//   selchange         LBN_SELCHANGE from the student list
+// Blank lines and lines starting with '#' are ignored.
+//
+// Commands run through the same controller as the window; the session
+// only stands in for the controls and counts the message boxes.
+
+typedef struct {
+    Student *students;
+    Controller controller;
+
+    // Form controls, as the recording sets them
+    ControllerForm form;
+
+    // Listboxes and output box, behind a counting view
+    ViewModel view;
+    ViewCounters viewUpdates;
+
+    int messageBoxes;   // Warnings and errors the UI would have shown
+} ReplaySession;
+
+// Latency samples for one command id
+typedef struct {
+    long long *samples;
+    int count;
+    int capacity;
+    long long totalNs;
+} ReplayLatency;
+
+typedef struct {
+    ReplayLatency commands[CMD_COUNT];
+    int lines;
+    int badLines;
+} ReplayStats;
+
+int replayInit(ReplaySession *session, int maxStudents);
+void replayFree(ReplaySession *session);
+void replayCommand(ReplaySession *session, int commandId);
+int replayLine(ReplaySession *session, const char *line, ReplayStats *stats);
+int replayFile(ReplaySession *session, FILE *file, ReplayStats *stats);
+void replayStatsFree(ReplayStats *stats);
+const char *replayCommandName(int commandId);
+
+// Recording helpers used by the Win32 front end
+void recordField(FILE *file, const char *key, const char *value);
+void recordSelection(FILE *file, int index);
+void recordCommand(FILE *file, int commandId);
+void recordFormCommand(FILE *file, int commandId, const ControllerForm *form);
+
+#endif
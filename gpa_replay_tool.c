@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_replay.h"
+#include "gpa_roster_gen.h"
+#include "gpa_stats.h"
+#include "gpa_timer.h"
+
+// Replays recorded advanced-calculator sessions headlessly and reports
+// per-command latency as one JSON object per line.
+
+static int compareLongLong(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Write a synthetic registrar day: enter each student, their courses,
+// calculate, and now and then go back to an earlier student or look one
+// up by the start of their name.
+static void generateRecording(FILE *out, int studentCount, unsigned long long seed) {
+    RosterGenOptions options;
+    RosterGen gen;
+    Student student;
+
+    rosterGenDefaults(&options);
+    options.seed = seed;
+    rosterGenInit(&gen, &options);
+
+    fprintf(out, "# synthetic session: %d students, seed %llu\n", studentCount, seed);
+    for (int i = 0; i < studentCount; i++) {
+        rosterGenStudent(&gen, &student);
+
+        recordField(out, "name", student.name);
+        recordCommand(out, CMD_ADD_STUDENT);
+        for (int j = 0; j < student.courseCount; j++) {
+            char credits[16];
+            sprintf(credits, "%d", student.courses[j].creditHours);
+            recordField(out, "course", student.courses[j].name);
+            recordField(out, "credits", credits);
+            recordField(out, "grade", student.courses[j].letterGrade);
+            recordCommand(out, CMD_ADD_COURSE);
+        }
+        recordCommand(out, CMD_CALCULATE_GPA);
+
+        if (i > 0 && rosterGenRandom(&gen) % 4 == 0) {
+            recordSelection(out, (int)(rosterGenRandom(&gen) % (unsigned int)i));
+            recordCommand(out, rosterGenRandom(&gen) % 2 ? CMD_SELCHANGE : CMD_SWITCH_STUDENT);
+            recordCommand(out, CMD_CALCULATE_GPA);
+        }
+        if (rosterGenRandom(&gen) % 8 == 0) {
+            char query[16];
+            snprintf(query, sizeof(query), "%.8s", student.name);
+            recordField(out, "find", query);
+            recordCommand(out, CMD_FIND);
+        }
+    }
+}
+
+static void printReport(const ReplaySession *session, ReplayStats *stats, long long wallNs) {
+    long long commands = 0;
+
+    for (int c = CMD_ADD_STUDENT; c < CMD_COUNT; c++) {
+        ReplayLatency *latency = &stats->commands[c];
+        if (latency->count == 0) continue;
+
+        qsort(latency->samples, latency->count, sizeof(long long), compareLongLong);
+        printf("{\"command\":\"%s\",\"count\":%d,\"mean_ns\":%.1f,\"p50_ns\":%lld,"
+               "\"p99_ns\":%lld,\"max_ns\":%lld}\n",
+               replayCommandName(c), latency->count, (double)latency->totalNs / latency->count,
+               latency->samples[latency->count / 2], latency->samples[(int)(latency->count * 0.99)],
+               latency->samples[latency->count - 1]);
+        commands += latency->count;
+    }
+
+    printf("{\"summary\":true,\"lines\":%d,\"bad_lines\":%d,\"commands\":%lld,\"students\":%d,"
+           "\"message_boxes\":%d,\"view_flushes\":%d,\"view_rows_sent\":%lld,"
+           "\"wall_ms\":%.3f,\"commands_per_sec\":%.0f}\n",
+           stats->lines, stats->badLines, commands, session->controller.studentCount, session->messageBoxes,
+           session->viewUpdates.flushes, session->viewUpdates.rowsSent,
+           wallNs / 1e6, wallNs > 0 ? commands * 1e9 / wallNs : 0.0);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--max-students N] [--stats FILE] RECORDING...\n"
+            "       %s --generate STUDENTS [--seed N] > RECORDING\n"
+            "  --max-students N  student capacity (default %d, as in the UI)\n"
+            "  --stats FILE      write latency histograms (builds with -DGPA_STATS)\n"
+            "  RECORDING may be '-' for standard input\n",
+            program, program, MAX_STUDENTS);
+}
+
+int main(int argc, char **argv) {
+    int maxStudents = MAX_STUDENTS;
+    int generate = 0;
+    unsigned long long seed = 1;
+    int firstFile = argc;
+    const char *statsPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-students") == 0 && i + 1 < argc) {
+            maxStudents = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            statsPath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            firstFile = i;
+            break;
+        }
+    }
+
+    if (generate > 0) {
+        generateRecording(stdout, generate, seed);
+        return 0;
+    }
+    if (firstFile == argc || maxStudents <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ReplaySession session;
+    ReplayStats stats;
+    if (!replayInit(&session, maxStudents)) {
+        fprintf(stderr, "Out of memory for %d students.\n", maxStudents);
+        return 1;
+    }
+    memset(&stats, 0, sizeof(stats));
+
+    long long wallNs = 0;
+    for (int i = firstFile; i < argc; i++) {
+        FILE *file = strcmp(argv[i], "-") == 0 ? stdin : fopen(argv[i], "r");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot open %s\n", argv[i]);
+            return 1;
+        }
+        long long start = nowNanoseconds();
+        replayFile(&session, file, &stats);
+        wallNs += nowNanoseconds() - start;
+        if (file != stdin) fclose(file);
+    }
+
+    printReport(&session, &stats, wallNs);
+
+    if (statsPath != NULL) {
+        FILE *statsFile = fopen(statsPath, "w");
+        if (statsFile == NULL) {
+            fprintf(stderr, "Cannot write %s\n", statsPath);
+        } else {
+#ifdef GPA_STATS
+            STATS_DUMP(statsFile);
+#else
+            fputs("# built without -DGPA_STATS\n", statsFile);
+#endif
+            fclose(statsFile);
+        }
+    }
+
+    replayStatsFree(&stats);
+    replayFree(&session);
+    return stats.badLines > 0 ? 2 : 0;
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_roster_gen.h"
+
+// Grade distribution presets, A+ through F
+static const unsigned int uniformWeights[GRADE_COUNT] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+static const unsigned int typicalWeights[GRADE_COUNT] = {4, 12, 10, 10, 12, 8, 7, 8, 5, 3, 3, 2, 4};
+static const unsigned int strugglingWeights[GRADE_COUNT] = {1, 2, 3, 4, 6, 7, 9, 12, 10, 9, 8, 7, 12};
+
+static const char *const departments[] = {
+    "MATH", "PHYS", "CHEM", "BIOL", "ENGL", "HIST", "CS", "ECON", "PSYC", "ART", "MUSC", "PHIL"
+};
+#define DEPARTMENT_COUNT (int)(sizeof(departments) / sizeof(departments[0]))
+
+static const char consonants[] = "bcdfghjklmnprstvwz";
+static const char vowels[] = "aeiou";
+
+// Fill options with a small, realistic roster
+void rosterGenDefaults(RosterGenOptions *options) {
+    memset(options, 0, sizeof(*options));
+    options->studentCount = 10000;
+    options->minCourses = 4;
+    options->maxCourses = 8;
+    options->minCredits = 1;
+    options->maxCredits = 4;
+    options->minNameLength = 8;
+    options->maxNameLength = 20;
+    memcpy(options->gradeWeights, typicalWeights, sizeof(typicalWeights));
+    options->seed = 1;
+}
+
+// Parse "uniform", "typical", "struggling" or 13 comma-separated weights
+int rosterGenParseGrades(const char *spec, unsigned int weights[GRADE_COUNT]) {
+    const char *p = spec;
+    unsigned int parsed[GRADE_COUNT];
+    int i;
+
+    if (strcmp(spec, "uniform") == 0) {
+        memcpy(weights, uniformWeights, sizeof(uniformWeights));
+        return 1;
+    }
+    if (strcmp(spec, "typical") == 0) {
+        memcpy(weights, typicalWeights, sizeof(typicalWeights));
+        return 1;
+    }
+    if (strcmp(spec, "struggling") == 0) {
+        memcpy(weights, strugglingWeights, sizeof(strugglingWeights));
+        return 1;
+    }
+
+    for (i = 0; i < GRADE_COUNT; i++) {
+        char *end;
+        parsed[i] = (unsigned int)strtoul(p, &end, 10);
+        if (end == p) return 0;
+        p = end;
+        if (i < GRADE_COUNT - 1) {
+            if (*p != ',') return 0;
+            p++;
+        }
+    }
+    if (*p != '\0') return 0;
+
+    memcpy(weights, parsed, sizeof(parsed));
+    return 1;
+}
+
+void rosterGenInit(RosterGen *gen, const RosterGenOptions *options) {
+    int i;
+
+    gen->options = *options;
+    if (gen->options.maxCourses > MAX_COURSES) gen->options.maxCourses = MAX_COURSES;
+    if (gen->options.minCourses > gen->options.maxCourses) gen->options.minCourses = gen->options.maxCourses;
+    if (gen->options.maxNameLength > NAME_LENGTH - 1) gen->options.maxNameLength = NAME_LENGTH - 1;
+    if (gen->options.minNameLength < 1) gen->options.minNameLength = 1;
+    if (gen->options.minNameLength > gen->options.maxNameLength) gen->options.minNameLength = gen->options.maxNameLength;
+    if (gen->options.minCredits < 1) gen->options.minCredits = 1;
+    if (gen->options.minCredits > gen->options.maxCredits) gen->options.maxCredits = gen->options.minCredits;
+
+    gen->state = options->seed;
+    gen->nextIndex = 0;
+    gen->weightTotal = 0;
+    for (i = 0; i < GRADE_COUNT; i++) {
+        gen->weightTotal += gen->options.gradeWeights[i];
+    }
+    if (gen->weightTotal == 0) {
+        memcpy(gen->options.gradeWeights, uniformWeights, sizeof(uniformWeights));
+        gen->weightTotal = GRADE_COUNT;
+    }
+}
+
+// splitmix64, upper 32 bits
+unsigned int rosterGenRandom(RosterGen *gen) {
+    unsigned long long z = (gen->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (unsigned int)((z ^ (z >> 31)) >> 32);
+}
+
+static int randomRange(RosterGen *gen, int low, int high) {
+    return low + (int)(rosterGenRandom(gen) % (unsigned int)(high - low + 1));
+}
+
+// Pronounceable "Firstname Lastname" of the requested length
+static void generateName(RosterGen *gen, char *name, int length) {
+    int split = length >= 6 ? length / 2 : -1;
+    int wordStart = 1;
+    int i;
+
+    for (i = 0; i < length; i++) {
+        char c;
+        if (i == split) {
+            name[i] = ' ';
+            wordStart = 1;
+            continue;
+        }
+        if (i % 2 == 0) {
+            c = consonants[rosterGenRandom(gen) % (sizeof(consonants) - 1)];
+        } else {
+            c = vowels[rosterGenRandom(gen) % (sizeof(vowels) - 1)];
+        }
+        name[i] = wordStart ? (char)(c - 'a' + 'A') : c;
+        wordStart = 0;
+    }
+    name[length] = '\0';
+}
+
+static int pickGrade(RosterGen *gen) {
+    unsigned int r = rosterGenRandom(gen) % gen->weightTotal;
+    int i;
+
+    for (i = 0; i < GRADE_COUNT - 1; i++) {
+        if (r < gen->options.gradeWeights[i]) return i;
+        r -= gen->options.gradeWeights[i];
+    }
+    return GRADE_COUNT - 1;
+}
+
+// Generate the next student with distinct course names and a computed GPA
+void rosterGenStudent(RosterGen *gen, Student *student) {
+    const RosterGenOptions *options = &gen->options;
+    int courseCount = randomRange(gen, options->minCourses, options->maxCourses);
+    int i;
+
+    generateName(gen, student->name, randomRange(gen, options->minNameLength, options->maxNameLength));
+    student->courseCount = 0;
+    student->gpa = 0.0f;
+
+    for (i = 0; i < courseCount; i++) {
+        char courseName[NAME_LENGTH];
+        int duplicate;
+        int j;
+
+        do {
+            sprintf(courseName, "%s %d", departments[rosterGenRandom(gen) % DEPARTMENT_COUNT],
+                    randomRange(gen, 100, 499));
+            duplicate = 0;
+            for (j = 0; j < student->courseCount; j++) {
+                if (strcmp(student->courses[j].name, courseName) == 0) {
+                    duplicate = 1;
+                    break;
+                }
+            }
+        } while (duplicate);
+
+        studentAddCourse(student, courseName, randomRange(gen, options->minCredits, options->maxCredits),
+                         gradeLetters[pickGrade(gen)]);
+    }
+
+    computeStudentGPA(student, NULL);
+    gen->nextIndex++;
+}
+
+void rosterGenFill(RosterGen *gen, Student *students, int count) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        rosterGenStudent(gen, &students[i]);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef GPA_ROSTER_GEN_H
+#define GPA_ROSTER_GEN_H
+
+#include "gpa_core.h"
+
+// Settings for the synthetic roster generator
+typedef struct {
+    int studentCount;
+    int minCourses, maxCourses;           // Courses per student, capped at MAX_COURSES
+    int minCredits, maxCredits;           // Credit hours per course
+    int minNameLength, maxNameLength;     // Student name length in characters
+    unsigned int gradeWeights[GRADE_COUNT]; // Relative frequency of A+ .. F
+    unsigned long long seed;
+} RosterGenOptions;
+
+// Generator state; the same options and seed always give the same roster
+typedef struct {
+    RosterGenOptions options;
+    unsigned long long state;
+    unsigned int weightTotal;
+    int nextIndex;
+} RosterGen;
+
+void rosterGenDefaults(RosterGenOptions *options);
+int rosterGenParseGrades(const char *spec, unsigned int weights[GRADE_COUNT]);
+void rosterGenInit(RosterGen *gen, const RosterGenOptions *options);
+unsigned int rosterGenRandom(RosterGen *gen);
+void rosterGenStudent(RosterGen *gen, Student *student);
+void rosterGenFill(RosterGen *gen, Student *students, int count);
+
+#endif
@@ -0,0 +1,533 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_numeric.h"
+#include "gpa_rules.h"
+
+#define RULE_BLOCK 4096
+#define RULE_BLOCK_WORDS (RULE_BLOCK / 64)
+#define RULE_STACK_MAX 16
+
+// min_grade/max_grade of a student without matching courses
+#define NO_COURSE_MIN 100.0f
+#define NO_COURSE_MAX -100.0f
+
+const char defaultStandingRules[] =
+    "deans_list: gpa >= 3.5 and credits >= 12\n"
+    "probation:  gpa < 2.0 and courses > 0\n"
+    "honors:     gpa >= 3.7 and min_grade(\"\") >= B\n";
+
+typedef struct {
+    const char *p;
+    RuleSet *set;
+    Rule *rule;
+    int line;
+    int depth;
+    int ok;
+} RuleParser;
+
+static void parseError(RuleParser *parser, const char *message) {
+    if (parser->ok) {
+        snprintf(parser->set->error, sizeof(parser->set->error), "line %d: %s", parser->line, message);
+    }
+    parser->ok = 0;
+}
+
+static void skipSpace(RuleParser *parser) {
+    while (*parser->p == ' ' || *parser->p == '\t' || *parser->p == '\r') parser->p++;
+    if (*parser->p == '#') {
+        while (*parser->p != '\0' && *parser->p != '\n') parser->p++;
+    }
+}
+
+// Consume keyword if it is the next word
+static int acceptWord(RuleParser *parser, const char *word) {
+    size_t length = strlen(word);
+    skipSpace(parser);
+    if (strncmp(parser->p, word, length) == 0 && !isalnum((unsigned char)parser->p[length]) &&
+        parser->p[length] != '_') {
+        parser->p += length;
+        return 1;
+    }
+    return 0;
+}
+
+static int acceptChar(RuleParser *parser, char c) {
+    skipSpace(parser);
+    if (*parser->p == c) {
+        parser->p++;
+        return 1;
+    }
+    return 0;
+}
+
+static void emit(RuleParser *parser, RuleInstrKind kind, int column, RuleCompare compare, float value) {
+    Rule *rule = parser->rule;
+    RuleInstr *instr;
+
+    if (!parser->ok) return;
+    if (rule->codeLength >= RULE_CODE_MAX) {
+        parseError(parser, "rule too long");
+        return;
+    }
+
+    instr = &rule->code[rule->codeLength++];
+    instr->kind = kind;
+    instr->column = column;
+    instr->compare = compare;
+    instr->value = value;
+
+    if (kind == INSTR_COMPARE) {
+        if (++parser->depth > RULE_STACK_MAX) parseError(parser, "rule nested too deeply");
+    } else if (kind != INSTR_NOT) {
+        parser->depth--;
+    }
+}
+
+static int findColumn(RuleParser *parser, RuleColumnKind kind, const char *prefix) {
+    RuleSet *set = parser->set;
+    int i;
+
+    for (i = 0; i < set->columnCount; i++) {
+        if (set->columns[i].kind == kind && strcmp(set->columns[i].prefix, prefix) == 0) return i;
+    }
+    if (set->columnCount >= RULE_COLUMNS_MAX) {
+        parseError(parser, "too many distinct operands");
+        return 0;
+    }
+    set->columns[set->columnCount].kind = kind;
+    strcpy(set->columns[set->columnCount].prefix, prefix);
+    return set->columnCount++;
+}
+
+static int parseOperand(RuleParser *parser) {
+    RuleColumnKind kind;
+    char prefix[RULE_PREFIX_LENGTH] = "";
+
+    if (acceptWord(parser, "gpa")) return findColumn(parser, COLUMN_GPA, "");
+    if (acceptWord(parser, "credits")) return findColumn(parser, COLUMN_CREDITS, "");
+    if (acceptWord(parser, "courses")) return findColumn(parser, COLUMN_COURSES, "");
+
+    if (acceptWord(parser, "min_grade")) {
+        kind = COLUMN_MIN_GRADE;
+    } else if (acceptWord(parser, "max_grade")) {
+        kind = COLUMN_MAX_GRADE;
+    } else {
+        parseError(parser, "expected gpa, credits, courses, min_grade or max_grade");
+        return 0;
+    }
+
+    if (!acceptChar(parser, '(') || !acceptChar(parser, '"')) {
+        parseError(parser, "expected (\"course prefix\")");
+        return 0;
+    }
+    size_t length = strcspn(parser->p, "\"\n");
+    if (parser->p[length] != '"' || length >= RULE_PREFIX_LENGTH) {
+        parseError(parser, "bad course prefix");
+        return 0;
+    }
+    memcpy(prefix, parser->p, length);
+    prefix[length] = '\0';
+    parser->p += length + 1;
+    if (!acceptChar(parser, ')')) {
+        parseError(parser, "expected )");
+        return 0;
+    }
+    return findColumn(parser, kind, prefix);
+}
+
+static int parseCompare(RuleParser *parser, RuleCompare *compare) {
+    skipSpace(parser);
+    const char *p = parser->p;
+    if (p[0] == '<' && p[1] == '=') *compare = RULE_LE;
+    else if (p[0] == '>' && p[1] == '=') *compare = RULE_GE;
+    else if (p[0] == '=' && p[1] == '=') *compare = RULE_EQ;
+    else if (p[0] == '!' && p[1] == '=') *compare = RULE_NE;
+    else if (p[0] == '<') *compare = RULE_LT;
+    else if (p[0] == '>') *compare = RULE_GT;
+    else return 0;
+    parser->p += (p[1] == '=') ? 2 : 1;
+    return 1;
+}
+
+// A number or a letter grade such as B+
+static int parseValue(RuleParser *parser, float *value) {
+    const char *end;
+
+    skipSpace(parser);
+    const char *p = parser->p;
+    if (strchr("ABCDF", p[0]) != NULL && p[0] != '\0') {
+        char grade[3] = {p[0], '\0', '\0'};
+        size_t length = 1;
+        if (p[1] == '+' || p[1] == '-') grade[length++] = p[1];
+        if (isalnum((unsigned char)p[length])) return 0;
+        *value = letterGradeToPoints(grade);
+        parser->p += length;
+        return 1;
+    }
+
+    if (!parseGrade(p, &end, value)) return 0;
+    parser->p = end;
+    return 1;
+}
+
+static void parseOr(RuleParser *parser);
+
+static void parseComparison(RuleParser *parser) {
+    RuleCompare compare;
+    float value;
+    int column = parseOperand(parser);
+
+    if (!parser->ok) return;
+    if (!parseCompare(parser, &compare)) {
+        parseError(parser, "expected < <= > >= == or !=");
+        return;
+    }
+    if (!parseValue(parser, &value)) {
+        parseError(parser, "expected a number or letter grade");
+        return;
+    }
+    emit(parser, INSTR_COMPARE, column, compare, value);
+}
+
+static void parseNot(RuleParser *parser) {
+    if (acceptWord(parser, "not")) {
+        parseNot(parser);
+        emit(parser, INSTR_NOT, 0, RULE_EQ, 0.0f);
+    } else if (acceptChar(parser, '(')) {
+        parseOr(parser);
+        if (!acceptChar(parser, ')')) parseError(parser, "expected )");
+    } else {
+        parseComparison(parser);
+    }
+}
+
+static void parseAnd(RuleParser *parser) {
+    parseNot(parser);
+    while (parser->ok && acceptWord(parser, "and")) {
+        parseNot(parser);
+        emit(parser, INSTR_AND, 0, RULE_EQ, 0.0f);
+    }
+}
+
+static void parseOr(RuleParser *parser) {
+    parseAnd(parser);
+    while (parser->ok && acceptWord(parser, "or")) {
+        parseAnd(parser);
+        emit(parser, INSTR_OR, 0, RULE_EQ, 0.0f);
+    }
+}
+
+// Compile rule text; returns 0 and fills set->error on a syntax error
+int rulesCompile(RuleSet *set, const char *text) {
+    RuleParser parser;
+
+    memset(set, 0, sizeof(*set));
+    parser.p = text;
+    parser.set = set;
+    parser.line = 1;
+    parser.ok = 1;
+
+    while (parser.ok && *parser.p != '\0') {
+        skipSpace(&parser);
+        if (*parser.p == '\n') {
+            parser.p++;
+            parser.line++;
+            continue;
+        }
+        if (*parser.p == '\0') break;
+
+        if (set->ruleCount >= RULES_MAX) {
+            parseError(&parser, "too many rules");
+            break;
+        }
+        parser.rule = &set->rules[set->ruleCount];
+        parser.depth = 0;
+
+        size_t length = 0;
+        while (isalnum((unsigned char)parser.p[length]) || parser.p[length] == '_') length++;
+        if (length == 0 || length >= RULE_NAME_LENGTH) {
+            parseError(&parser, "expected a rule name");
+            break;
+        }
+        memcpy(parser.rule->name, parser.p, length);
+        parser.rule->name[length] = '\0';
+        parser.p += length;
+        if (!acceptChar(&parser, ':')) {
+            parseError(&parser, "expected ':' after the rule name");
+            break;
+        }
+
+        parseOr(&parser);
+        skipSpace(&parser);
+        if (parser.ok && *parser.p != '\n' && *parser.p != '\0') parseError(&parser, "unexpected text");
+        if (parser.ok) set->ruleCount++;
+    }
+    return parser.ok;
+}
+
+static int hasPrefix(const char *name, const char *prefix) {
+    while (*prefix != '\0') {
+        if (*name++ != *prefix++) return 0;
+    }
+    return 1;
+}
+
+// Every column the rules use, for one student; GPA and credits come from
+// the same function as the displayed GPA
+static void studentColumns(const RuleSet *set, const Student *student, float *values) {
+    float points[MAX_COURSES];
+    int credits = 0;
+    float gpa = weightedGPA(student, points, &credits);
+    int c, j;
+
+    for (c = 0; c < set->columnCount; c++) {
+        const RuleColumn *column = &set->columns[c];
+        float value = 0.0f;
+
+        switch (column->kind) {
+            case COLUMN_GPA: value = gpa; break;
+            case COLUMN_CREDITS: value = (float)credits; break;
+            case COLUMN_COURSES: value = (float)student->courseCount; break;
+            case COLUMN_MIN_GRADE:
+            case COLUMN_MAX_GRADE: {
+                int isMin = column->kind == COLUMN_MIN_GRADE;
+                value = isMin ? NO_COURSE_MIN : NO_COURSE_MAX;
+                for (j = 0; j < student->courseCount; j++) {
+                    if (!hasPrefix(student->courses[j].name, column->prefix)) continue;
+                    if (isMin ? points[j] < value : points[j] > value) value = points[j];
+                }
+                break;
+            }
+        }
+        values[c] = value;
+    }
+}
+
+// One pass over the roster to fill every column the rules use
+int rulesExtract(const RuleSet *set, const Student *students, int count, RuleTable *table) {
+    float values[RULE_COLUMNS_MAX];
+    int c, i;
+
+    memset(table, 0, sizeof(*table));
+    table->studentCount = count;
+    table->paddedCount = (count + RULE_BLOCK - 1) / RULE_BLOCK * RULE_BLOCK;
+    for (c = 0; c < set->columnCount; c++) {
+        table->columns[c] = calloc(table->paddedCount > 0 ? table->paddedCount : 1, sizeof(float));
+        if (table->columns[c] == NULL) {
+            rulesFreeTable(table);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        studentColumns(set, &students[i], values);
+        for (c = 0; c < set->columnCount; c++) table->columns[c][i] = values[c];
+    }
+    return 1;
+}
+
+// 64 comparisons into one word, with no branch on the data
+#define COMPARE_BLOCK(OP)                                               \
+    for (w = 0; w < RULE_BLOCK_WORDS; w++) {                            \
+        const float *v = values + w * 64;                               \
+        RuleWord bits = 0;                                              \
+        for (b = 0; b < 64; b++) bits |= (RuleWord)(v[b] OP limit) << b; \
+        out[w] = bits;                                                  \
+    }
+
+static void compareBlock(const float *values, RuleCompare compare, float limit, RuleWord *out) {
+    int w, b;
+
+    switch (compare) {
+        case RULE_LT: COMPARE_BLOCK(<); break;
+        case RULE_LE: COMPARE_BLOCK(<=); break;
+        case RULE_GT: COMPARE_BLOCK(>); break;
+        case RULE_GE: COMPARE_BLOCK(>=); break;
+        case RULE_EQ: COMPARE_BLOCK(==); break;
+        case RULE_NE: COMPARE_BLOCK(!=); break;
+    }
+}
+
+static int popcount64(RuleWord x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Run every rule over the table, block by block
+int rulesEvaluate(const RuleSet *set, const RuleTable *table, RuleResults *results) {
+    RuleWord stack[RULE_STACK_MAX][RULE_BLOCK_WORDS];
+    int words = table->paddedCount / 64;
+    int r, k, w, block;
+
+    memset(results, 0, sizeof(*results));
+    results->studentCount = table->studentCount;
+    results->words = (table->studentCount + 63) / 64;
+    for (r = 0; r < set->ruleCount; r++) {
+        results->flags[r] = malloc(sizeof(RuleWord) * (words > 0 ? words : 1));
+        if (results->flags[r] == NULL) {
+            rulesFreeResults(results);
+            return 0;
+        }
+    }
+
+    for (block = 0; block < table->paddedCount; block += RULE_BLOCK) {
+        for (r = 0; r < set->ruleCount; r++) {
+            const Rule *rule = &set->rules[r];
+            int top = 0;
+
+            for (k = 0; k < rule->codeLength; k++) {
+                const RuleInstr *instr = &rule->code[k];
+                RuleWord *a, *b;
+
+                switch (instr->kind) {
+                    case INSTR_COMPARE:
+                        compareBlock(table->columns[instr->column] + block, instr->compare, instr->value,
+                                     stack[top++]);
+                        break;
+                    case INSTR_AND:
+                        a = stack[top - 2];
+                        b = stack[--top];
+                        for (w = 0; w < RULE_BLOCK_WORDS; w++) a[w] &= b[w];
+                        break;
+                    case INSTR_OR:
+                        a = stack[top - 2];
+                        b = stack[--top];
+                        for (w = 0; w < RULE_BLOCK_WORDS; w++) a[w] |= b[w];
+                        break;
+                    case INSTR_NOT:
+                        a = stack[top - 1];
+                        for (w = 0; w < RULE_BLOCK_WORDS; w++) a[w] = ~a[w];
+                        break;
+                }
+            }
+            memcpy(results->flags[r] + block / 64, stack[0], sizeof(stack[0]));
+        }
+    }
+
+    // Clear the padding students and count matches
+    for (r = 0; r < set->ruleCount; r++) {
+        if (table->studentCount % 64 != 0) {
+            results->flags[r][results->words - 1] &= (1ULL << (table->studentCount % 64)) - 1;
+        }
+        for (w = 0; w < results->words; w++) {
+            results->counts[r] += popcount64(results->flags[r][w]);
+        }
+    }
+    return 1;
+}
+
+int ruleMatches(const RuleResults *results, int rule, int student) {
+    return (int)((results->flags[rule][student / 64] >> (student % 64)) & 1);
+}
+
+static int compareValue(float value, RuleCompare compare, float limit) {
+    switch (compare) {
+        case RULE_LT: return value < limit;
+        case RULE_LE: return value <= limit;
+        case RULE_GT: return value > limit;
+        case RULE_GE: return value >= limit;
+        case RULE_EQ: return value == limit;
+        case RULE_NE: return value != limit;
+    }
+    return 0;
+}
+
+// Every rule for one student, without a table: bit r set when rule r
+// matches (RULES_MAX is 64)
+RuleWord rulesMatchStudent(const RuleSet *set, const Student *student) {
+    float values[RULE_COLUMNS_MAX];
+    int stack[RULE_STACK_MAX];
+    RuleWord matches = 0;
+    int r, k;
+
+    studentColumns(set, student, values);
+    for (r = 0; r < set->ruleCount; r++) {
+        const Rule *rule = &set->rules[r];
+        int top = 0;
+
+        for (k = 0; k < rule->codeLength; k++) {
+            const RuleInstr *instr = &rule->code[k];
+
+            switch (instr->kind) {
+                case INSTR_COMPARE:
+                    stack[top++] = compareValue(values[instr->column], instr->compare, instr->value);
+                    break;
+                case INSTR_AND:
+                    top--;
+                    stack[top - 1] = stack[top - 1] && stack[top];
+                    break;
+                case INSTR_OR:
+                    top--;
+                    stack[top - 1] = stack[top - 1] || stack[top];
+                    break;
+                case INSTR_NOT:
+                    stack[top - 1] = !stack[top - 1];
+                    break;
+            }
+        }
+        if (stack[0]) matches |= 1ULL << r;
+    }
+    return matches;
+}
+
+// Comma-separated names of the rules a student matches, or "none"
+int formatRuleFlags(char *buf, size_t size, const RuleSet *set, const RuleResults *results, int student) {
+    RuleWord matches = 0;
+    int r;
+
+    for (r = 0; r < set->ruleCount; r++) {
+        if (ruleMatches(results, r, student)) matches |= 1ULL << r;
+    }
+    return formatRuleMask(buf, size, set, matches);
+}
+
+// The same, from a rulesMatchStudent mask
+int formatRuleMask(char *buf, size_t size, const RuleSet *set, RuleWord matches) {
+    int length = 0;
+    int r;
+
+    buf[0] = '\0';
+    for (r = 0; r < set->ruleCount; r++) {
+        if (!((matches >> r) & 1)) continue;
+        length += snprintf(buf + length, size - length, "%s%s", length > 0 ? ", " : "", set->rules[r].name);
+        if ((size_t)length >= size) return (int)size - 1;
+    }
+    if (length == 0) length = snprintf(buf, size, "none");
+    return length;
+}
+
+// Append the output box's "Standing: ..." line for a student; shared by
+// the calculator and the replay so both show the same text
+int appendStandingLine(char *buf, size_t size, const RuleSet *set, const Student *student) {
+    static const char label[] = "\r\nStanding: ";
+    size_t length = strlen(buf);
+
+    if (length + sizeof(label) >= size) return (int)length;     // No room for a flag after the label
+    memcpy(buf + length, label, sizeof(label));
+    length += sizeof(label) - 1;
+    return (int)length + formatRuleMask(buf + length, size - length, set, rulesMatchStudent(set, student));
+}
+
+void rulesFreeTable(RuleTable *table) {
+    int c;
+    for (c = 0; c < RULE_COLUMNS_MAX; c++) {
+        free(table->columns[c]);
+        table->columns[c] = NULL;
+    }
+}
+
+void rulesFreeResults(RuleResults *results) {
+    int r;
+    for (r = 0; r < RULES_MAX; r++) {
+        free(results->flags[r]);
+        results->flags[r] = NULL;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef GPA_RULES_H
+#define GPA_RULES_H
+
+#include "gpa_core.h"
+
+// Academic standing rules (dean's list, probation, ...) evaluated over a
+// whole roster at once. Rule text, one rule per line:
+//
+//   deans_list: gpa >= 3.5 and credits >= 12
+//   probation:  gpa < 2.0
+//   major_ok:   min_grade("CS") >= C and not (courses < 4)
+//
+// Operands: gpa, credits, courses, min_grade("prefix"), max_grade("prefix").
+// min_grade/max_grade look at courses whose name starts with prefix; a
+// student with no such course passes min_grade(...) >= x and fails
+// max_grade(...) >= x. Values are numbers or letter grades (A+ .. F).
+// Operators: < <= > >= == !=, and, or, not, parentheses. '#' starts a comment.
+//
+// Rules compile to a small stack program of column comparisons. Evaluation
+// runs each program over blocks of 4096 students, turning comparisons into
+// 64-student bit masks without branches, and yields one bitset per rule.
+// A single student (the calculator's Calculate GPA) is evaluated directly,
+// with the same column values and comparisons.
+
+#define RULES_MAX 64
+#define RULE_COLUMNS_MAX 32
+#define RULE_CODE_MAX 64
+#define RULE_NAME_LENGTH 32
+#define RULE_PREFIX_LENGTH 16
+
+typedef enum {
+    COLUMN_GPA,
+    COLUMN_CREDITS,
+    COLUMN_COURSES,
+    COLUMN_MIN_GRADE,
+    COLUMN_MAX_GRADE
+} RuleColumnKind;
+
+typedef struct {
+    RuleColumnKind kind;
+    char prefix[RULE_PREFIX_LENGTH];
+} RuleColumn;
+
+typedef enum { RULE_LT, RULE_LE, RULE_GT, RULE_GE, RULE_EQ, RULE_NE } RuleCompare;
+
+typedef enum { INSTR_COMPARE, INSTR_AND, INSTR_OR, INSTR_NOT } RuleInstrKind;
+
+typedef struct {
+    RuleInstrKind kind;
+    int column;
+    RuleCompare compare;
+    float value;
+} RuleInstr;
+
+typedef struct {
+    char name[RULE_NAME_LENGTH];
+    RuleInstr code[RULE_CODE_MAX];
+    int codeLength;
+} Rule;
+
+typedef struct {
+    Rule rules[RULES_MAX];
+    int ruleCount;
+    RuleColumn columns[RULE_COLUMNS_MAX];
+    int columnCount;
+    char error[128];
+} RuleSet;
+
+// Column values of a roster, padded to whole blocks
+typedef struct {
+    int studentCount;
+    int paddedCount;
+    float *columns[RULE_COLUMNS_MAX];
+} RuleTable;
+
+typedef unsigned long long RuleWord;
+
+// One bitset per rule: bit i set when student i matches
+typedef struct {
+    int studentCount;
+    int words;
+    RuleWord *flags[RULES_MAX];
+    int counts[RULES_MAX];
+} RuleResults;
+
+// Dean's list, probation and honors as used by the calculator
+extern const char defaultStandingRules[];
+
+int rulesCompile(RuleSet *set, const char *text);
+int rulesExtract(const RuleSet *set, const Student *students, int count, RuleTable *table);
+int rulesEvaluate(const RuleSet *set, const RuleTable *table, RuleResults *results);
+int ruleMatches(const RuleResults *results, int rule, int student);
+RuleWord rulesMatchStudent(const RuleSet *set, const Student *student);
+int formatRuleFlags(char *buf, size_t size, const RuleSet *set, const RuleResults *results, int student);
+int formatRuleMask(char *buf, size_t size, const RuleSet *set, RuleWord matches);
+int appendStandingLine(char *buf, size_t size, const RuleSet *set, const Student *student);
+void rulesFreeTable(RuleTable *table);
+void rulesFreeResults(RuleResults *results);
+
+#endif
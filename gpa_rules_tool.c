@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_import.h"
+#include "gpa_roster_gen.h"
+#include "gpa_rules.h"
+#include "gpa_timer.h"
+
+// Evaluates standing rules over a roster in the import format (or a
+// synthetic one) and prints how many students each rule flags.
+
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (file == NULL) return NULL;
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    data = malloc((size_t)size + 1);
+    if (data != NULL) {
+        *length = fread(data, 1, (size_t)size, file);
+        data[*length] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s RULES (--roster FILE | --generate STUDENTS [--seed N]) [--list RULE]\n"
+            "  RULES        rule file, see gpa_rules.h for the syntax\n"
+            "  --roster     roster in the import format (see gpa_import.h)\n"
+            "  --generate   synthetic roster of STUDENTS students\n"
+            "  --list RULE  also print the names of the students RULE flags\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    const char *rulesPath = NULL, *rosterPath = NULL, *listRule = NULL;
+    int generate = 0;
+    unsigned long long seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--roster") == 0 && value != NULL) {
+            rosterPath = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0 && value != NULL) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--list") == 0 && value != NULL) {
+            listRule = argv[++i];
+        } else if (argv[i][0] != '-' && rulesPath == NULL) {
+            rulesPath = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (rulesPath == NULL || (rosterPath == NULL) == (generate <= 0)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t length;
+    char *rulesText = readFile(rulesPath, &length);
+    if (rulesText == NULL) {
+        fprintf(stderr, "Cannot read %s\n", rulesPath);
+        return 1;
+    }
+    RuleSet *set = malloc(sizeof(RuleSet));
+    if (set == NULL || !rulesCompile(set, rulesText)) {
+        fprintf(stderr, "%s: %s\n", rulesPath, set != NULL ? set->error : "out of memory");
+        return 1;
+    }
+    free(rulesText);
+
+    // Load or generate the roster
+    Student *students;
+    int count;
+    if (rosterPath != NULL) {
+        char *rosterText = readFile(rosterPath, &length);
+        if (rosterText == NULL) {
+            fprintf(stderr, "Cannot read %s\n", rosterPath);
+            return 1;
+        }
+        // At most one student per line
+        int maxStudents = 1;
+        for (size_t i = 0; i < length; i++) maxStudents += rosterText[i] == '\n';
+        students = malloc(sizeof(Student) * maxStudents);
+        if (students == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        count = importRoster(rosterText, length, students, maxStudents, NULL);
+        free(rosterText);
+    } else {
+        RosterGenOptions options;
+        RosterGen gen;
+        rosterGenDefaults(&options);
+        options.seed = seed;
+        rosterGenInit(&gen, &options);
+        count = generate;
+        students = malloc(sizeof(Student) * count);
+        if (students == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        rosterGenFill(&gen, students, count);
+    }
+
+    RuleTable table;
+    RuleResults results;
+    long long start = nowNanoseconds();
+    if (!rulesExtract(set, students, count, &table)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    long long extracted = nowNanoseconds();
+    if (!rulesEvaluate(set, &table, &results)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    long long evaluated = nowNanoseconds();
+
+    for (int r = 0; r < set->ruleCount; r++) {
+        printf("{\"rule\":\"%s\",\"matches\":%d,\"students\":%d}\n", set->rules[r].name, results.counts[r], count);
+    }
+    printf("{\"summary\":true,\"rules\":%d,\"students\":%d,\"extract_ms\":%.3f,\"evaluate_ms\":%.3f}\n",
+           set->ruleCount, count, (extracted - start) / 1e6, (evaluated - extracted) / 1e6);
+
+    if (listRule != NULL) {
+        for (int r = 0; r < set->ruleCount; r++) {
+            if (strcmp(set->rules[r].name, listRule) != 0) continue;
+            for (int i = 0; i < count; i++) {
+                if (ruleMatches(&results, r, i)) printf("%s\n", students[i].name);
+            }
+        }
+    }
+
+    rulesFreeResults(&results);
+    rulesFreeTable(&table);
+    free(students);
+    free(set);
+    return 0;
+}
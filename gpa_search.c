@@ -0,0 +1,576 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_search.h"
+
+// Longest normalized name kept, leading space included
+#define SEARCH_MAX_NAME 256
+#define MAX_EDITS 2
+
+// Output kept free for the "...and N more" line until the last hit
+#define SEARCH_MORE_ROOM 24
+
+// Query scratch: candidate counts keep these bits besides the count
+#define WORD_START 0x80     // Has " " + the query's first two letters
+#define NAME_START 0x40     // Begins with the query's first two letters
+#define SORT_KEYS ((3 * MAX_EDITS + 1) * 3 * SEARCH_MAX_NAME)
+
+// Candidates are read in a known order; fetch their names a few ahead
+#if defined(__GNUC__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)0)
+#endif
+
+static int charCode(char c) {
+    if (c >= 'a' && c <= 'z') return c - 'a' + 1;
+    if (c >= '0' && c <= '9') return c - '0' + 27;
+    return 0;
+}
+
+static int trigramAt(const char *text) {
+    return (charCode(text[0]) * 37 + charCode(text[1])) * 37 + charCode(text[2]);
+}
+
+// List of the names whose normalized form begins with these two characters
+static int nameStartAt(const char *text) {
+    return SEARCH_TRIGRAMS + charCode(text[0]) * 37 + charCode(text[1]);
+}
+
+static unsigned int hashName(const char *name) {
+    unsigned int hash = 2166136261u;
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int searchInit(SearchIndex *index) {
+    memset(index, 0, sizeof(*index));
+    index->postings = calloc(SEARCH_LISTS, sizeof(SearchPostings));
+    return index->postings != NULL;
+}
+
+void searchFree(SearchIndex *index) {
+    int i;
+
+    if (index->postings != NULL) {
+        for (i = 0; i < SEARCH_LISTS; i++) free(index->postings[i].entries);
+    }
+    free(index->postings);
+    free(index->entries);
+    free(index->names);
+    free(index->courseSlots);
+    free(index->lengths);
+    free(index->counts);
+    free(index->touched);
+    free(index->keys);
+    free(index->order);
+    memset(index, 0, sizeof(*index));
+}
+
+// Lowercase letters and digits; any other run of bytes becomes one space,
+// none at either end. Returns the length written (out is always terminated).
+int searchNormalize(const char *text, char *out, int size) {
+    int length = 0;
+    int gap = 0;
+
+    if (size <= 0) return 0;
+    for (; *text != '\0' && length < size - 1; text++) {
+        char c = *text;
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (charCode(c) == 0) {
+            gap = length > 0;
+            continue;
+        }
+        if (gap && length < size - 2) out[length++] = ' ';
+        gap = 0;
+        out[length++] = c;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+static int post(SearchPostings *list, int entry) {
+    if (list->count > 0 && list->entries[list->count - 1] == entry) return 1;  // Repeated in the name
+    if (list->count == list->capacity) {
+        int capacity = list->capacity > 0 ? list->capacity * 2 : 4;
+        int *grown = realloc(list->entries, sizeof(int) * capacity);
+        if (grown == NULL) return 0;
+        list->entries = grown;
+        list->capacity = capacity;
+    }
+    list->entries[list->count++] = entry;
+    return 1;
+}
+
+static int growNames(SearchIndex *index, size_t needed) {
+    size_t size = index->namesCapacity > 0 ? index->namesCapacity : 4096;
+    char *grown;
+
+    if (needed <= index->namesCapacity) return 1;
+    while (size < needed) size *= 2;
+    grown = realloc(index->names, size);
+    if (grown == NULL) return 0;
+    index->names = grown;
+    index->namesCapacity = size;
+    return 1;
+}
+
+// Store an entry and post its trigrams; returns its id or -1
+static int addEntry(SearchIndex *index, const char *normalized, int length, const char *display, int student) {
+    size_t displayLength = strlen(display);
+    SearchEntry *entry;
+    int id = index->entryCount;
+    int i;
+
+    if (index->entryCount == index->entryCapacity) {
+        int capacity = index->entryCapacity > 0 ? index->entryCapacity * 2 : 1024;
+        SearchEntry *grown = realloc(index->entries, sizeof(SearchEntry) * capacity);
+        unsigned char *lengths;
+        if (grown == NULL) return -1;
+        index->entries = grown;
+        lengths = realloc(index->lengths, capacity);
+        if (lengths == NULL) return -1;
+        index->lengths = lengths;
+        index->entryCapacity = capacity;
+    }
+    if (!growNames(index, index->namesLength + length + displayLength + 2)) return -1;
+
+    entry = &index->entries[id];
+    entry->name = index->namesLength;
+    memcpy(index->names + entry->name, normalized, length + 1);
+    entry->display = entry->name + length + 1;
+    memcpy(index->names + entry->display, display, displayLength + 1);
+    index->lengths[id] = (unsigned char)length;
+    entry->student = student;
+    entry->takers = 0;
+
+    for (i = 0; i + 3 <= length; i++) {
+        if (!post(&index->postings[trigramAt(normalized + i)], id)) return -1;
+    }
+    if (length >= 3 && !post(&index->postings[nameStartAt(normalized + 1)], id)) return -1;
+    index->namesLength += length + displayLength + 2;
+    index->entryCount++;
+    return id;
+}
+
+// " " + normalized name; returns its length
+static int indexedForm(const char *name, char out[SEARCH_MAX_NAME]) {
+    out[0] = ' ';
+    return searchNormalize(name, out + 1, SEARCH_MAX_NAME - 1) + 1;
+}
+
+int searchAddStudent(SearchIndex *index, int student, const char *name) {
+    char normalized[SEARCH_MAX_NAME];
+    int length = indexedForm(name, normalized);
+
+    return addEntry(index, normalized, length, name, student) >= 0;
+}
+
+static int rehashCourses(SearchIndex *index, int slotCount) {
+    int *slots = malloc(sizeof(int) * slotCount);
+    int i;
+
+    if (slots == NULL) return 0;
+    for (i = 0; i < slotCount; i++) slots[i] = -1;
+    for (i = 0; i < index->entryCount; i++) {
+        unsigned int slot;
+        if (index->entries[i].student >= 0) continue;
+        slot = hashName(index->names + index->entries[i].name) & (slotCount - 1);
+        while (slots[slot] >= 0) slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = i;
+    }
+    free(index->courseSlots);
+    index->courseSlots = slots;
+    index->courseSlotCount = slotCount;
+    return 1;
+}
+
+// Slot of a normalized course name: its entry, or the empty slot for it
+static int findCourse(const SearchIndex *index, const char *normalized) {
+    unsigned int slot = hashName(normalized) & (index->courseSlotCount - 1);
+    int id;
+
+    while ((id = index->courseSlots[slot]) >= 0) {
+        if (strcmp(index->names + index->entries[id].name, normalized) == 0) break;
+        slot = (slot + 1) & (index->courseSlotCount - 1);
+    }
+    return (int)slot;
+}
+
+// One more student takes the course; the name is indexed on first use
+int searchAddCourse(SearchIndex *index, const char *name) {
+    char normalized[SEARCH_MAX_NAME];
+    int length = indexedForm(name, normalized);
+    int slot, id;
+
+    // Keep the table at most half full
+    if ((index->courseCount + 1) * 2 > index->courseSlotCount &&
+        !rehashCourses(index, index->courseSlotCount > 0 ? index->courseSlotCount * 2 : 1024)) {
+        return 0;
+    }
+    slot = findCourse(index, normalized);
+    id = index->courseSlots[slot];
+    if (id < 0) {
+        id = addEntry(index, normalized, length, name, -1);
+        if (id < 0) return 0;
+        index->courseSlots[slot] = id;
+        index->courseCount++;
+    }
+    index->entries[id].takers++;
+    return 1;
+}
+
+// One student fewer takes the course; at zero it drops out of results
+void searchRemoveCourse(SearchIndex *index, const char *name) {
+    char normalized[SEARCH_MAX_NAME];
+    int id;
+
+    if (index->courseSlotCount == 0) return;
+    indexedForm(name, normalized);
+    id = index->courseSlots[findCourse(index, normalized)];
+    if (id >= 0 && index->entries[id].takers > 0) index->entries[id].takers--;
+}
+
+// Fewest edits turning pattern into some substring of text, bit-parallel
+// (Myers): one 64-bit step per text character. equal[c] has bit i set
+// when pattern[i] has code c.
+static int bestDistance(const unsigned long long equal[37], int m, const char *text, int n) {
+    unsigned long long positive = ~0ULL, negative = 0ULL;
+    unsigned long long last = 1ULL << (m - 1);
+    int score = m, best = m;
+    int j;
+
+    for (j = 0; j < n; j++) {
+        unsigned long long eq = equal[charCode(text[j])];
+        unsigned long long xv = eq | negative;
+        unsigned long long xh = (((eq & positive) + positive) ^ positive) | eq;
+        unsigned long long hp = negative | ~(xh | positive);
+        unsigned long long hn = positive & xh;
+
+        if (hp & last) {
+            score++;
+        } else if (hn & last) {
+            score--;
+        }
+        hp <<= 1;
+        hn <<= 1;
+        positive = hn | ~(xv | hp);
+        negative = hp & xv;
+        if (score < best) best = score;
+    }
+    return best;
+}
+
+// Same distance by dynamic programming (Sellers), also giving where in
+// text the best substring begins; only run for hits
+static int matchDistance(const char *pattern, int m, const char *text, int n, int *start) {
+    int cost[SEARCH_MAX_QUERY + 2], from[SEARCH_MAX_QUERY + 2];
+    int best = m, bestStart = 0;
+    int i, j;
+
+    for (i = 0; i <= m; i++) {
+        cost[i] = i;
+        from[i] = 0;
+    }
+    for (j = 1; j <= n; j++) {
+        int diagonal = 0, diagonalFrom = j - 1;
+        cost[0] = 0;
+        from[0] = j;
+        for (i = 1; i <= m; i++) {
+            int value = diagonal + (pattern[i - 1] != text[j - 1]);
+            int origin = diagonalFrom;
+            diagonal = cost[i];
+            diagonalFrom = from[i];
+            if (cost[i] + 1 < value) {
+                value = cost[i] + 1;
+                origin = from[i];
+            }
+            if (cost[i - 1] + 1 < value) {
+                value = cost[i - 1] + 1;
+                origin = from[i - 1];
+            }
+            cost[i] = value;
+            from[i] = origin;
+        }
+        if (cost[m] < best) {
+            best = cost[m];
+            bestStart = from[m];
+        }
+    }
+    *start = bestStart;
+    return best;
+}
+
+static int growScratch(SearchIndex *index) {
+    unsigned char *counts;
+    int *touched, *keys, *order;
+
+    if (index->scratchCapacity >= index->entryCount) return 1;
+    counts = calloc(index->entryCapacity, 1);
+    touched = malloc(sizeof(int) * index->entryCapacity);
+    keys = malloc(sizeof(int) * index->entryCapacity);
+    order = malloc(sizeof(int) * index->entryCapacity);
+    if (counts == NULL || touched == NULL || keys == NULL || order == NULL) {
+        free(counts);
+        free(touched);
+        free(keys);
+        free(order);
+        return 0;
+    }
+    free(index->counts);
+    free(index->touched);
+    free(index->keys);
+    free(index->order);
+    index->counts = counts;
+    index->touched = touched;
+    index->keys = keys;
+    index->order = order;
+    index->scratchCapacity = index->entryCapacity;
+    return 1;
+}
+
+// Insert into hits, kept sorted by score; returns the new count
+static int rankHit(SearchHit *hits, int count, int max, const SearchHit *hit) {
+    int i;
+
+    if (count == max && hits[count - 1].score <= hit->score) return count;
+    i = count < max ? count++ : count - 1;
+    for (; i > 0 && hits[i - 1].score > hit->score; i--) hits[i] = hits[i - 1];
+    hits[i] = *hit;
+    return count;
+}
+
+static void markCandidates(SearchIndex *index, const SearchPostings *list, int bit) {
+    int i;
+
+    for (i = 0; i < list->count; i++) {
+        int id = list->entries[i];
+        if (index->counts[id] != 0) index->counts[id] |= (unsigned char)bit;
+    }
+}
+
+// Candidate order: trigrams shared (most first), then where an exact match
+// could be (start of the name, a word start, mid-word), then length
+static int sortKey(const SearchIndex *index, int id, int distinct) {
+    int count = index->counts[id];
+    int group = distinct - (count & ~(WORD_START | NAME_START));
+    int place = (count & NAME_START) ? 0 : (count & WORD_START) ? 1 : 2;
+
+    return (group * 3 + place) * SEARCH_MAX_NAME + index->lengths[id];
+}
+
+// A normalized query as both searchQuery and searchScan match it
+typedef struct {
+    char text[SEARCH_MAX_QUERY + 2];    // " " + normalized query
+    const char *pattern;                // What names must contain
+    int patternLength;
+    int trigrams[SEARCH_MAX_QUERY];     // Distinct trigrams of pattern
+    int distinct;
+    int edits;                          // Typos allowed
+    unsigned long long equal[37];       // Pattern positions per character code
+} QueryPattern;
+
+// Returns 0 for queries too short to search
+static int preparePattern(const char *query, QueryPattern *q) {
+    int length;
+    int i, j;
+
+    q->text[0] = ' ';
+    length = searchNormalize(query, q->text + 1, SEARCH_MAX_QUERY + 1);
+    if (length < 2) return 0;
+
+    // Two letters only make one trigram with the leading space: a word prefix
+    q->pattern = length < 3 ? q->text : q->text + 1;
+    q->patternLength = length < 3 ? length + 1 : length;
+
+    q->distinct = 0;
+    for (i = 0; i + 3 <= q->patternLength; i++) {
+        int trigram = trigramAt(q->pattern + i);
+        for (j = 0; j < q->distinct && q->trigrams[j] != trigram; j++) {}
+        if (j == q->distinct) q->trigrams[q->distinct++] = trigram;
+    }
+
+    // Typos allowed, keeping at least two trigrams in common: with only one
+    // required, every name sharing any trigram would be a candidate
+    q->edits = MAX_EDITS;
+    while (q->edits > 0 && q->distinct - 3 * q->edits < 2) q->edits--;
+
+    memset(q->equal, 0, sizeof(q->equal));
+    for (i = 0; i < q->patternLength; i++) q->equal[charCode(q->pattern[i])] |= 1ULL << i;
+    return 1;
+}
+
+// Score a name found distance typos from the query
+static void makeHit(const SearchIndex *index, const QueryPattern *q, int id, int distance, SearchHit *hit) {
+    const SearchEntry *entry = &index->entries[id];
+    const char *name = index->names + entry->name;
+    int nameLength = index->lengths[id];
+    int start, wordStart;
+
+    matchDistance(q->pattern, q->patternLength, name, nameLength, &start);
+
+    // Word starts first, then the start of the name, then shorter names
+    wordStart = start == 0 || name[start - 1] == ' ' || name[start] == ' ';
+    hit->kind = entry->student >= 0 ? SEARCH_STUDENT : SEARCH_COURSE;
+    hit->student = entry->student;
+    hit->takers = entry->takers;
+    hit->name = index->names + entry->display;
+    hit->edits = distance;
+    hit->score = ((distance * 4 + (wordStart ? 0 : 2) + (start <= 1 ? 0 : 1)) << 8) + nameLength;
+}
+
+// Ranked students and courses whose name is within a few typos of the
+// query, best first; returns the number of hits, or -1 when out of memory.
+//
+// Every posting list of the query is counted once. A name sharing count
+// of the distinct trigrams is at least (distinct - count + 2) / 3 typos
+// away, and where its name has the query's first two letters bounds where
+// an exact match can be. With the name length, that gives each candidate a
+// floor on its score before its name is read. Candidates are visited in
+// order of that floor and a run stops at the first that cannot make the
+// top max.
+int searchQuery(SearchIndex *index, const char *query, SearchHit *hits, int max) {
+    QueryPattern q;
+    int keyEnd[SORT_KEYS + 1];
+    const SearchPostings *lists[SEARCH_MAX_QUERY];
+    int distinct, edits, keys, candidates, run, nameLength;
+    int touchedCount = 0, hitCount = 0;
+    int i, j;
+
+    if (max <= 0 || !preparePattern(query, &q)) return 0;
+    distinct = q.distinct;
+    edits = q.edits;
+
+    // Shortest lists first: a name close enough shares at least
+    // distinct - 3 * edits trigrams, so it is in one of the first
+    // 3 * edits + 1; the longer lists only add to those names' counts
+    for (i = 0; i < distinct; i++) {
+        const SearchPostings *list = &index->postings[q.trigrams[i]];
+        for (j = i; j > 0 && lists[j - 1]->count > list->count; j--) lists[j] = lists[j - 1];
+        lists[j] = list;
+    }
+
+    if (!growScratch(index)) return -1;
+    for (i = 0; i < distinct; i++) {
+        if (i <= 3 * edits) {
+            for (j = 0; j < lists[i]->count; j++) {
+                int id = lists[i]->entries[j];
+                if (index->counts[id]++ == 0) index->touched[touchedCount++] = id;
+            }
+        } else {
+            for (j = 0; j < lists[i]->count; j++) {
+                int id = lists[i]->entries[j];
+                if (index->counts[id] != 0) index->counts[id]++;
+            }
+        }
+    }
+
+    // An exact match at a word start needs " " + the first two letters,
+    // and one at the start of the name needs the name to begin with them;
+    // without, a name can rank no better than a later or mid-word match
+    markCandidates(index, &index->postings[trigramAt(q.text)], WORD_START);
+    markCandidates(index, &index->postings[nameStartAt(q.text + 1)], NAME_START);
+
+    // Order the candidates by trigrams shared (most first), then where an
+    // exact match could be, then length, dropping those too far off
+    // (counting sort); afterwards bucket k ends at keyEnd[k]
+    keys = (3 * edits + 1) * 3 * SEARCH_MAX_NAME;
+    memset(keyEnd, 0, sizeof(int) * (keys + 1));
+    for (i = 0; i < touchedCount; i++) {
+        int id = index->touched[i];
+        int key = sortKey(index, id, distinct);
+        index->keys[i] = key;
+        index->counts[id] = 0;
+        if (key < keys) keyEnd[key + 1]++;
+    }
+    for (i = 1; i <= keys; i++) keyEnd[i] += keyEnd[i - 1];
+    for (i = 0; i < touchedCount; i++) {
+        if (index->keys[i] < keys) index->order[keyEnd[index->keys[i]]++] = index->touched[i];
+    }
+    candidates = keyEnd[keys - 1];
+
+    for (run = 0; run < keys / SEARCH_MAX_NAME; run++) {
+        static const int placeFloor[3] = {0, 1, 3};
+        int least = (run / 3 + 2) / 3;      // Fewest typos that keep this many trigrams
+        int floor = (least * 4 + (least == 0 ? placeFloor[run % 3] : 0)) << 8;
+
+        for (nameLength = 0; nameLength < SEARCH_MAX_NAME; nameLength++) {
+            int key = run * SEARCH_MAX_NAME + nameLength;
+
+            if (key > 0 ? keyEnd[key - 1] == keyEnd[key] : keyEnd[0] == 0) continue;
+            if (hitCount == max && floor + nameLength >= hits[max - 1].score) break;   // The rest are longer
+            for (i = key > 0 ? keyEnd[key - 1] : 0; i < keyEnd[key]; i++) {
+                const SearchEntry *entry = &index->entries[index->order[i]];
+                int distance;
+                SearchHit hit;
+
+                if (i + 8 < candidates) PREFETCH(&index->entries[index->order[i + 8]]);
+                if (i + 4 < candidates) PREFETCH(index->names + index->entries[index->order[i + 4]].name);
+
+                if (entry->student < 0 && entry->takers == 0) continue;
+                distance = bestDistance(q.equal, q.patternLength, index->names + entry->name, nameLength);
+                if (distance > edits) continue;
+                makeHit(index, &q, index->order[i], distance, &hit);
+                hitCount = rankHit(hits, hitCount, max, &hit);
+            }
+        }
+    }
+    return hitCount;
+}
+
+// The hits searchQuery should find, by reading every name: no trigram
+// counts, no candidate order, no early stop. Slow; it is the reference
+// gpa_search --verify checks the pruning against. Hits with equal scores
+// may come in a different order.
+int searchScan(const SearchIndex *index, const char *query, SearchHit *hits, int max) {
+    QueryPattern q;
+    int hitCount = 0;
+    int id;
+
+    if (max <= 0 || !preparePattern(query, &q)) return 0;
+    for (id = 0; id < index->entryCount; id++) {
+        const SearchEntry *entry = &index->entries[id];
+        int distance;
+        SearchHit hit;
+
+        if (entry->student < 0 && entry->takers == 0) continue;
+        distance = bestDistance(q.equal, q.patternLength, index->names + entry->name, index->lengths[id]);
+        if (distance > q.edits) continue;
+        makeHit(index, &q, id, distance, &hit);
+        hitCount = rankHit(hits, hitCount, max, &hit);
+    }
+    return hitCount;
+}
+
+// Output box text for Find: one line per hit, whole lines only, and
+// "...and N more" for the hits that did not fit. Shared by the calculator
+// and the replay so both show the same text.
+int formatSearchHits(char *buf, size_t size, const SearchHit *hits, int count) {
+    size_t length = 0;
+    int shown, n;
+
+    if (size == 0) return 0;
+    buf[0] = '\0';
+    for (shown = 0; shown < count; shown++) {
+        size_t room = size - length;
+        if (shown + 1 < count) room = room > SEARCH_MORE_ROOM ? room - SEARCH_MORE_ROOM : 0;
+        if (room == 0) break;
+        if (hits[shown].kind == SEARCH_STUDENT) {
+            n = snprintf(buf + length, room, "Student: %s\r\n", hits[shown].name);
+        } else {
+            n = snprintf(buf + length, room, "Course: %s (%d students)\r\n", hits[shown].name, hits[shown].takers);
+        }
+        if (n < 0 || (size_t)n >= room) break;
+        length += (size_t)n;
+    }
+    buf[length] = '\0';
+
+    if (shown < count) {
+        n = snprintf(buf + length, size - length, "...and %d more", count - shown);
+        if (n > 0) length += (size_t)n < size - length ? (size_t)n : size - length - 1;
+    }
+    return (int)length;
+}
@@ -0,0 +1,89 @@
+#ifndef GPA_SEARCH_H
+#define GPA_SEARCH_H
+
+#include <stddef.h>
+
+// Fuzzy name search over students and courses. Names are normalized
+// (ASCII letters lowercased, digits kept, everything else collapsed to a
+// single space) and every trigram of " " + name is posted to an inverted
+// index; the leading space gives each word start its own trigrams. Course
+// names are interned, so a course taken by thousands of students is one
+// entry with a count.
+//
+// A query matches names containing it, anywhere, within up to two typos,
+// as long as two of its trigrams are left in common: for a one-word query
+// that is 1 typo from 7 letters and 2 from 10. One typo breaks at most
+// three trigrams, so the number
+// of query trigrams a name shares bounds its typos from below; names are
+// checked from the most shared down and the search stops when that bound
+// rules out the rest. Hits rank by typos, then matches at a word start,
+// then at the start of the name, then shorter names. Two-letter queries
+// match word prefixes.
+//
+// Adds are incremental: posting lists stay sorted because entry ids only
+// grow.
+
+#define SEARCH_TRIGRAMS (37 * 37 * 37)
+#define SEARCH_LISTS (SEARCH_TRIGRAMS + 37 * 37)     // Trigrams, then the first two letters of names
+#define SEARCH_MAX_QUERY 64
+
+typedef enum {
+    SEARCH_STUDENT,
+    SEARCH_COURSE
+} SearchKind;
+
+typedef struct {
+    SearchKind kind;
+    int student;            // Student index, for student hits
+    int takers;             // Students taking the course, for course hits
+    const char *name;       // As entered; valid until the next add
+    int edits;              // Typos between the query and the match
+    int score;              // Lower ranks first
+} SearchHit;
+
+typedef struct {
+    size_t name;            // Offset of " " + normalized name in names
+    size_t display;         // Offset of the name as entered
+    int student;            // Student index, or -1 for a course
+    int takers;             // Course only; 0 once no student takes it
+} SearchEntry;
+
+typedef struct {
+    int *entries;
+    int count, capacity;
+} SearchPostings;
+
+typedef struct {
+    SearchPostings *postings;       // SEARCH_LISTS lists of entry ids
+
+    SearchEntry *entries;
+    unsigned char *lengths;         // Normalized length per entry, leading space included
+    int entryCount, entryCapacity;
+    char *names;
+    size_t namesLength, namesCapacity;
+
+    // Course name interning: normalized name -> entry id
+    int *courseSlots;
+    int courseSlotCount, courseCount;
+
+    // Query scratch, per entry
+    unsigned char *counts;          // Query trigrams in the name
+    int *touched;                   // Entries with a nonzero count
+    int *keys;                      // Their sort keys
+    int *order;                     // The candidates among them, best first
+    int scratchCapacity;
+} SearchIndex;
+
+int searchInit(SearchIndex *index);
+void searchFree(SearchIndex *index);
+int searchNormalize(const char *text, char *out, int size);
+
+int searchAddStudent(SearchIndex *index, int student, const char *name);
+int searchAddCourse(SearchIndex *index, const char *name);
+void searchRemoveCourse(SearchIndex *index, const char *name);
+
+int searchQuery(SearchIndex *index, const char *query, SearchHit *hits, int max);
+int searchScan(const SearchIndex *index, const char *query, SearchHit *hits, int max);
+int formatSearchHits(char *buf, size_t size, const SearchHit *hits, int count);
+
+#endif
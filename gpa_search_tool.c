@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_import.h"
+#include "gpa_roster_gen.h"
+#include "gpa_search.h"
+#include "gpa_timer.h"
+
+// Fuzzy name search over a roster. Queries come from the command line, or
+// one per line on stdin; each prints its ranked hits. --sample runs that
+// many queries made from the roster's own names (with a typo, a prefix or
+// a fragment) and reports the latency. --verify checks every query's
+// ranked scores against a scan of all names. A JSON summary goes to stderr.
+
+#define MAX_HITS 50
+
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (file == NULL) return NULL;
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+    data = malloc((size_t)size + 1);
+    if (data != NULL) {
+        *length = fread(data, 1, (size_t)size, file);
+        data[*length] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+static int indexStudents(SearchIndex *index, const Student *students, int first, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!searchAddStudent(index, first + i, students[i].name)) return 0;
+        for (int j = 0; j < students[i].courseCount; j++) {
+            if (!searchAddCourse(index, students[i].courses[j].name)) return 0;
+        }
+    }
+    return 1;
+}
+
+static void printHits(const char *query, const SearchHit *hits, int count) {
+    printf("%s\n", query);
+    for (int i = 0; i < count; i++) {
+        if (hits[i].kind == SEARCH_STUDENT) {
+            printf("  student %d\t%s\t%d typo%s\n", hits[i].student, hits[i].name, hits[i].edits,
+                   hits[i].edits == 1 ? "" : "s");
+        } else {
+            printf("  course\t%s\t%d student%s\t%d typo%s\n", hits[i].name, hits[i].takers,
+                   hits[i].takers == 1 ? "" : "s", hits[i].edits, hits[i].edits == 1 ? "" : "s");
+        }
+    }
+}
+
+// A student name with one typo, its first letters, or a piece of it
+static void sampleQuery(RosterGen *gen, const SearchIndex *index, char *query, size_t size) {
+    const SearchEntry *entry;
+    size_t length;
+
+    do {
+        entry = &index->entries[rosterGenRandom(gen) % index->entryCount];
+    } while (entry->student < 0);
+    snprintf(query, size, "%s", index->names + entry->display);
+    length = strlen(query);
+    if (length < 4) return;
+    switch (rosterGenRandom(gen) % 3) {
+        case 0:
+            query[rosterGenRandom(gen) % length] = "aeiouxz"[rosterGenRandom(gen) % 7];
+            break;
+        case 1:
+            query[2 + rosterGenRandom(gen) % 4] = '\0';
+            break;
+        default: {
+            size_t start = rosterGenRandom(gen) % (length - 3);
+            memmove(query, query + start, length - start + 1);
+            query[3 + rosterGenRandom(gen) % 5] = '\0';
+            break;
+        }
+    }
+}
+
+// Same hit count and the same score at every rank as a full scan; hits
+// with equal scores may be listed in either order
+static int verifyQuery(const SearchIndex *index, const char *query, const SearchHit *hits, int count, int top) {
+    SearchHit expected[MAX_HITS];
+    int expectedCount = searchScan(index, query, expected, top);
+    int ok = count == expectedCount;
+
+    for (int i = 0; ok && i < count; i++) {
+        ok = hits[i].score == expected[i].score && hits[i].edits == expected[i].edits;
+    }
+    if (!ok) {
+        fprintf(stderr, "Mismatch for \"%s\": %d hits, scan found %d\n", query, count, expectedCount);
+        for (int i = 0; i < count || i < expectedCount; i++) {
+            fprintf(stderr, "  %d: %s %d | %s %d\n", i + 1, i < count ? hits[i].name : "-",
+                    i < count ? hits[i].score : -1, i < expectedCount ? expected[i].name : "-",
+                    i < expectedCount ? expected[i].score : -1);
+        }
+    }
+    return ok;
+}
+
+static int compareLongLong(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s (--roster FILE | --generate STUDENTS) [--seed N] [--top K] [--sample N] [--verify] [QUERY...]\n"
+            "  --roster FILE     roster in the import format\n"
+            "  --generate N      synthetic roster of N students\n"
+            "  --top K           hits per query (default 10, at most %d)\n"
+            "  --sample N        run N queries made from the roster's names, print only timing\n"
+            "  --verify          check each query's ranked scores against a scan of every name\n"
+            "Without queries or --sample, queries are read from stdin, one per line.\n",
+            program, MAX_HITS);
+}
+
+int main(int argc, char **argv) {
+    const char *rosterPath = NULL;
+    int generate = 0, top = 10, samples = 0, queryCount = 0, verify = 0;
+    unsigned long long seed = 1;
+    const char **queries = malloc(sizeof(char *) * argc);
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--roster") == 0 && value != NULL) {
+            rosterPath = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0 && value != NULL) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--top") == 0 && value != NULL) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sample") == 0 && value != NULL) {
+            samples = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (argv[i][0] != '-') {
+            queries[queryCount++] = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((rosterPath == NULL) == (generate <= 0) || top <= 0 || top > MAX_HITS || samples < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    SearchIndex index;
+    RosterGenOptions options;
+    RosterGen gen;
+    int students = 0;
+    if (!searchInit(&index)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    rosterGenDefaults(&options);
+    options.seed = seed;
+    rosterGenInit(&gen, &options);
+
+    // Index as the calculator does, one Add Student / addCourse at a time
+    long long start = nowNanoseconds();
+    if (rosterPath != NULL) {
+        size_t length;
+        char *text = readFile(rosterPath, &length);
+        if (text == NULL) {
+            fprintf(stderr, "Cannot read %s\n", rosterPath);
+            return 1;
+        }
+        int maxStudents = 1;
+        for (size_t i = 0; i < length; i++) maxStudents += text[i] == '\n';
+        Student *roster = malloc(sizeof(Student) * maxStudents);
+        if (roster == NULL) return 1;
+        students = importRoster(text, length, roster, maxStudents, NULL);
+        if (!indexStudents(&index, roster, 0, students)) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        free(roster);
+        free(text);
+    } else {
+        Student *chunk = malloc(sizeof(Student) * 1024);
+        if (chunk == NULL) return 1;
+        for (students = 0; students < generate; students += 1024) {
+            int count = generate - students < 1024 ? generate - students : 1024;
+            rosterGenFill(&gen, chunk, count);
+            if (!indexStudents(&index, chunk, students, count)) {
+                fprintf(stderr, "Out of memory\n");
+                return 1;
+            }
+        }
+        students = generate;
+        free(chunk);
+    }
+    long long built = nowNanoseconds();
+
+    SearchHit hits[MAX_HITS];
+    long long *latencies = malloc(sizeof(long long) * (samples > 0 ? samples : 1));
+    long long searched = 0, totalNs = 0, mismatches = 0;
+    char line[256];
+    for (int i = 0; i < queryCount || (queryCount == 0 && samples == 0 && fgets(line, sizeof(line), stdin)); i++) {
+        const char *query = line;
+        if (i < queryCount) {
+            query = queries[i];
+        } else {
+            line[strcspn(line, "\r\n")] = '\0';
+        }
+        long long queryStart = nowNanoseconds();
+        int count = searchQuery(&index, query, hits, top);
+        totalNs += nowNanoseconds() - queryStart;
+        searched++;
+        printHits(query, hits, count);
+        if (verify && !verifyQuery(&index, query, hits, count, top)) mismatches++;
+    }
+    for (int i = 0; i < samples && students > 0; i++) {
+        sampleQuery(&gen, &index, line, sizeof(line));
+        long long queryStart = nowNanoseconds();
+        int count = searchQuery(&index, line, hits, top);
+        latencies[i] = nowNanoseconds() - queryStart;
+        totalNs += latencies[i];
+        searched++;
+        if (verify && !verifyQuery(&index, line, hits, count, top)) mismatches++;
+    }
+
+    fprintf(stderr, "{\"students\":%d,\"courses\":%d,\"entries\":%d,\"build_ms\":%.1f,\"queries\":%lld,"
+            "\"mean_us\":%.1f",
+            students, index.courseCount, index.entryCount, (built - start) / 1e6, searched,
+            searched > 0 ? totalNs / 1e3 / searched : 0.0);
+    if (samples > 0 && students > 0) {
+        qsort(latencies, samples, sizeof(long long), compareLongLong);
+        fprintf(stderr, ",\"p50_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f", latencies[samples / 2] / 1e3,
+                latencies[samples * 99 / 100] / 1e3, latencies[samples - 1] / 1e3);
+    }
+    if (verify) fprintf(stderr, ",\"mismatches\":%lld", mismatches);
+    fprintf(stderr, "}\n");
+    free(latencies);
+    free(queries);
+    searchFree(&index);
+    return mismatches > 0 ? 1 : 0;
+}
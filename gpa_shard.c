@@ -0,0 +1,530 @@
+#define _POSIX_C_SOURCE 200809L
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "gpa_shard.h"
+
+typedef enum {
+    MSG_ADD = 1,        // count ShardStudent records; reply count of records not stored
+    MSG_GET,            // id; reply count 1 + Student, or count 0
+    MSG_STATS,          // reply ShardStats
+    MSG_TOP,            // count n; reply up to n RankEntry in rank order
+    MSG_FIND,           // count max, payload name text; reply best matching RankEntry
+    MSG_QUIT
+} MessageType;
+
+typedef struct {
+    int type;
+    int count;
+    unsigned int id;
+    int size;           // Payload bytes after the header
+} Message;
+
+static int writeAll(int fd, const void *data, size_t size) {
+    const char *p = data;
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+static int readAll(int fd, void *data, size_t size) {
+    char *p = data;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+static int sendMessage(int fd, int type, int count, unsigned int id, const void *payload, int size) {
+    Message message;
+    message.type = type;
+    message.count = count;
+    message.id = id;
+    message.size = size;
+    return writeAll(fd, &message, sizeof(message)) && (size == 0 || writeAll(fd, payload, (size_t)size));
+}
+
+// GPA descending, then credits descending, then id, as in gpa_rank
+static int rankBefore(const RankEntry *a, const RankEntry *b) {
+    if (a->gpa != b->gpa) return a->gpa > b->gpa;
+    if (a->credits != b->credits) return a->credits > b->credits;
+    return a->id < b->id;
+}
+
+static int compareRank(const void *a, const void *b) {
+    if (rankBefore(a, b)) return -1;
+    return rankBefore(b, a) ? 1 : 0;
+}
+
+static int containsNoCase(const char *text, const char *lowerNeedle) {
+    size_t length = strlen(lowerNeedle);
+    for (; *text != '\0'; text++) {
+        size_t i = 0;
+        while (i < length && tolower((unsigned char)text[i]) == lowerNeedle[i]) i++;
+        if (i == length) return 1;
+    }
+    return length == 0;
+}
+
+// ---- Worker side ----
+
+typedef struct {
+    ShardStudent *students;
+    int count, capacity;
+    int *slots;             // Open addressing: id -> index, -1 empty
+    int slotCount;
+} WorkerStore;
+
+static unsigned int hashId(unsigned int id) {
+    return id * 2654435761u;
+}
+
+static int storeRehash(WorkerStore *store, int slotCount) {
+    int *slots = malloc(sizeof(int) * slotCount);
+    int i;
+
+    if (slots == NULL) return 0;
+    for (i = 0; i < slotCount; i++) slots[i] = -1;
+    for (i = 0; i < store->count; i++) {
+        unsigned int slot = hashId(store->students[i].id) & (slotCount - 1);
+        while (slots[slot] >= 0) slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = i;
+    }
+    free(store->slots);
+    store->slots = slots;
+    store->slotCount = slotCount;
+    return 1;
+}
+
+// Slot holding id, or the empty slot where it would go
+static unsigned int storeSlot(const WorkerStore *store, unsigned int id) {
+    unsigned int slot = hashId(id) & (store->slotCount - 1);
+    while (store->slots[slot] >= 0 && store->students[store->slots[slot]].id != id) {
+        slot = (slot + 1) & (store->slotCount - 1);
+    }
+    return slot;
+}
+
+// Insert or replace; returns 0 when out of memory
+static int storePut(WorkerStore *store, const ShardStudent *record) {
+    unsigned int slot;
+
+    if ((store->count + 1) * 2 > store->slotCount && !storeRehash(store, store->slotCount > 0 ? store->slotCount * 2 : 1024)) {
+        return 0;
+    }
+    slot = storeSlot(store, record->id);
+    if (store->slots[slot] < 0) {
+        if (store->count == store->capacity) {
+            int capacity = store->capacity > 0 ? store->capacity * 2 : 1024;
+            ShardStudent *grown = realloc(store->students, sizeof(ShardStudent) * capacity);
+            if (grown == NULL) return 0;
+            store->students = grown;
+            store->capacity = capacity;
+        }
+        store->slots[slot] = store->count++;
+    }
+    store->students[store->slots[slot]] = *record;
+    computeStudentGPA(&store->students[store->slots[slot]].student, NULL);
+    return 1;
+}
+
+static void toRankEntry(const ShardStudent *record, RankEntry *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->gpa = record->student.gpa;
+    entry->credits = totalCreditHours(&record->student);
+    entry->id = record->id;
+    snprintf(entry->name, sizeof(entry->name), "%s", record->student.name);
+}
+
+static void workerStats(const WorkerStore *store, ShardStats *stats) {
+    int i;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->minGPA = 4.0f;
+    for (i = 0; i < store->count; i++) {
+        const Student *student = &store->students[i].student;
+        int bucket = (int)(student->gpa * 10.0f + 0.5f);
+        if (bucket < 0) bucket = 0;
+        if (bucket >= SHARD_GPA_BUCKETS) bucket = SHARD_GPA_BUCKETS - 1;
+
+        stats->students++;
+        stats->courses += student->courseCount;
+        stats->credits += totalCreditHours(student);
+        stats->gpaSum += student->gpa;
+        stats->gpaSquares += (double)student->gpa * student->gpa;
+        if (student->gpa < stats->minGPA) stats->minGPA = student->gpa;
+        if (student->gpa > stats->maxGPA) stats->maxGPA = student->gpa;
+        stats->histogram[bucket]++;
+    }
+}
+
+// Keep the best n in a heap whose root is the worst kept entry, counting
+// only students whose name contains lowerNeedle unless it is NULL
+static int workerTop(const WorkerStore *store, const char *lowerNeedle, int n, RankEntry *heap) {
+    int size = 0;
+    int i;
+
+    for (i = 0; i < store->count && n > 0; i++) {
+        RankEntry entry;
+        int at;
+
+        // Most students lose to the current worst on GPA alone
+        if (size == n && store->students[i].student.gpa < heap[0].gpa) continue;
+        if (lowerNeedle != NULL && !containsNoCase(store->students[i].student.name, lowerNeedle)) continue;
+        toRankEntry(&store->students[i], &entry);
+        if (size < n) {
+            // Sift up
+            at = size++;
+            while (at > 0 && rankBefore(&heap[(at - 1) / 2], &entry)) {
+                heap[at] = heap[(at - 1) / 2];
+                at = (at - 1) / 2;
+            }
+            heap[at] = entry;
+        } else if (rankBefore(&entry, &heap[0])) {
+            // Replace the root and sift down
+            at = 0;
+            for (;;) {
+                int child = 2 * at + 1;
+                if (child >= size) break;
+                if (child + 1 < size && rankBefore(&heap[child], &heap[child + 1])) child++;
+                if (!rankBefore(&entry, &heap[child])) break;
+                heap[at] = heap[child];
+                at = child;
+            }
+            heap[at] = entry;
+        }
+    }
+    qsort(heap, size, sizeof(RankEntry), compareRank);
+    return size;
+}
+
+static void workerMain(int fd) {
+    WorkerStore store;
+    char *payload = NULL;
+    int payloadCapacity = 0;
+    Message message;
+
+    memset(&store, 0, sizeof(store));
+    while (readAll(fd, &message, sizeof(message)) && message.type != MSG_QUIT) {
+        if (message.size > payloadCapacity) {
+            char *grown = realloc(payload, (size_t)message.size);
+            if (grown == NULL) break;
+            payload = grown;
+            payloadCapacity = message.size;
+        }
+        if (message.size > 0 && !readAll(fd, payload, (size_t)message.size)) break;
+
+        if (message.type == MSG_ADD) {
+            const ShardStudent *records = (const ShardStudent *)payload;
+            int failed = 0;
+            int i;
+            for (i = 0; i < message.count; i++) failed += !storePut(&store, &records[i]);
+            if (!sendMessage(fd, MSG_ADD, failed, 0, NULL, 0)) break;
+        } else if (message.type == MSG_GET) {
+            int index = store.slotCount > 0 ? store.slots[storeSlot(&store, message.id)] : -1;
+            const Student *student = index >= 0 ? &store.students[index].student : NULL;
+            if (!sendMessage(fd, MSG_GET, index >= 0, message.id, student, index >= 0 ? (int)sizeof(Student) : 0)) {
+                break;
+            }
+        } else if (message.type == MSG_STATS) {
+            ShardStats stats;
+            workerStats(&store, &stats);
+            if (!sendMessage(fd, MSG_STATS, 1, 0, &stats, sizeof(stats))) break;
+        } else if (message.type == MSG_TOP || message.type == MSG_FIND) {
+            int max = message.count > 0 ? message.count : 0;
+            RankEntry *entries = malloc(sizeof(RankEntry) * (max > 0 ? max : 1));
+            int count = 0;
+            int i;
+
+            if (entries == NULL) break;
+            if (message.type == MSG_TOP) {
+                count = workerTop(&store, NULL, max, entries);
+            } else {
+                char needle[NAME_LENGTH];
+                int length = message.size < NAME_LENGTH ? message.size : NAME_LENGTH - 1;
+                for (i = 0; i < length; i++) needle[i] = (char)tolower((unsigned char)payload[i]);
+                needle[length] = '\0';
+                count = workerTop(&store, needle, max, entries);
+            }
+            i = sendMessage(fd, message.type, count, 0, entries, count * (int)sizeof(RankEntry));
+            free(entries);
+            if (!i) break;
+        }
+    }
+
+    free(payload);
+    free(store.students);
+    free(store.slots);
+    close(fd);
+    _exit(0);
+}
+
+// ---- Coordinator side ----
+
+static void markDown(Shard *shard) {
+    if (shard->fd < 0) return;
+    close(shard->fd);
+    shard->fd = -1;
+    shard->pendingCount = 0;
+    shard->unacked = 0;
+    kill(shard->pid, SIGKILL);
+    waitpid(shard->pid, NULL, 0);
+}
+
+// Fork one worker per shard; returns 0 if any could not be started
+int shardStart(ShardCluster *cluster, int shardCount) {
+    int i, j;
+
+    memset(cluster, 0, sizeof(*cluster));
+    if (shardCount < 1 || shardCount > SHARD_MAX) return 0;
+
+    // Unflushed output would otherwise be written once per worker
+    fflush(NULL);
+    for (i = 0; i < shardCount; i++) {
+        Shard *shard = &cluster->shards[i];
+        int fds[2];
+
+        shard->fd = -1;
+        shard->pending = malloc(sizeof(ShardStudent) * SHARD_ADD_BATCH);
+        if (shard->pending == NULL || socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            cluster->shardCount = i + 1;
+            shardStop(cluster);
+            return 0;
+        }
+
+        shard->pid = fork();
+        if (shard->pid == 0) {
+            // Worker: keep only its own end of its own socket
+            for (j = 0; j < i; j++) close(cluster->shards[j].fd);
+            close(fds[0]);
+            workerMain(fds[1]);
+        }
+        close(fds[1]);
+        if (shard->pid < 0) {
+            close(fds[0]);
+            cluster->shardCount = i + 1;
+            shardStop(cluster);
+            return 0;
+        }
+        shard->fd = fds[0];
+    }
+    cluster->shardCount = shardCount;
+    return 1;
+}
+
+void shardStop(ShardCluster *cluster) {
+    int i;
+
+    for (i = 0; i < cluster->shardCount; i++) {
+        Shard *shard = &cluster->shards[i];
+        if (shard->fd >= 0) {
+            sendMessage(shard->fd, MSG_QUIT, 0, 0, NULL, 0);
+            close(shard->fd);
+            waitpid(shard->pid, NULL, 0);
+            shard->fd = -1;
+        }
+        free(shard->pending);
+        shard->pending = NULL;
+    }
+    cluster->shardCount = 0;
+}
+
+int shardAlive(const ShardCluster *cluster, int shard) {
+    return cluster->shards[shard].fd >= 0;
+}
+
+int shardOf(const ShardCluster *cluster, unsigned int id) {
+    return (int)(id % (unsigned int)cluster->shardCount);
+}
+
+// Read add replies until at most keep are outstanding, counting what the
+// worker could not store. The window keeps the replies small enough to sit
+// in the socket buffer, so neither side blocks on the other while adding.
+static int readAcks(Shard *shard, int keep) {
+    Message reply;
+
+    while (shard->unacked > keep) {
+        if (!readAll(shard->fd, &reply, sizeof(reply)) || reply.type != MSG_ADD || reply.size != 0) {
+            markDown(shard);
+            return 0;
+        }
+        shard->dropped += reply.count;
+        shard->unacked--;
+    }
+    return 1;
+}
+
+static int flushShard(Shard *shard) {
+    if (shard->fd < 0) return 0;
+    if (shard->pendingCount == 0) return 1;
+    if (!readAcks(shard, SHARD_ACK_WINDOW - 1)) return 0;
+    if (!sendMessage(shard->fd, MSG_ADD, shard->pendingCount, 0, shard->pending,
+                     shard->pendingCount * (int)sizeof(ShardStudent))) {
+        markDown(shard);
+        return 0;
+    }
+    shard->pendingCount = 0;
+    shard->unacked++;
+    return 1;
+}
+
+// Send queued students and read every add reply, so the next reply on the
+// socket is the answer to the next request
+static int settleShard(Shard *shard) {
+    return flushShard(shard) && readAcks(shard, 0);
+}
+
+// Queue a student for its shard; adding an existing id replaces it.
+// Returns 0 if the owning shard is down.
+int shardAddStudent(ShardCluster *cluster, unsigned int id, const Student *student) {
+    Shard *shard = &cluster->shards[shardOf(cluster, id)];
+
+    if (shard->fd < 0) return 0;
+    if (shard->pendingCount == SHARD_ADD_BATCH && !flushShard(shard)) return 0;
+    shard->pending[shard->pendingCount].id = id;
+    shard->pending[shard->pendingCount].student = *student;
+    shard->pendingCount++;
+    return 1;
+}
+
+// Send all queued students; returns the number of shards still up
+int shardFlush(ShardCluster *cluster) {
+    int alive = 0;
+    int i;
+
+    for (i = 0; i < cluster->shardCount; i++) alive += settleShard(&cluster->shards[i]);
+    return alive;
+}
+
+// Returns 1 and fills student, 0 if unknown, -1 if the owning shard is down
+int shardGetStudent(ShardCluster *cluster, unsigned int id, Student *student) {
+    Shard *shard = &cluster->shards[shardOf(cluster, id)];
+    Message reply;
+
+    if (!settleShard(shard)) return -1;
+    if (!sendMessage(shard->fd, MSG_GET, 0, id, NULL, 0) || !readAll(shard->fd, &reply, sizeof(reply)) ||
+        (reply.count > 0 && (reply.size != (int)sizeof(Student) || !readAll(shard->fd, student, sizeof(Student))))) {
+        markDown(shard);
+        return -1;
+    }
+    return reply.count > 0;
+}
+
+// Send a request to every live shard; they work on it in parallel
+static void broadcast(ShardCluster *cluster, int type, int count, const void *payload, int size) {
+    int i;
+
+    for (i = 0; i < cluster->shardCount; i++) {
+        Shard *shard = &cluster->shards[i];
+        if (settleShard(shard) && !sendMessage(shard->fd, type, count, 0, payload, size)) markDown(shard);
+    }
+}
+
+// Read one shard's reply into data (at most capacity bytes); returns the reply, count -1 on failure
+static Message receive(Shard *shard, void *data, int capacity) {
+    Message reply;
+
+    reply.count = -1;
+    if (shard->fd < 0) return reply;
+    if (!readAll(shard->fd, &reply, sizeof(reply)) || reply.size > capacity ||
+        (reply.size > 0 && !readAll(shard->fd, data, (size_t)reply.size))) {
+        markDown(shard);
+        reply.count = -1;
+    }
+    return reply;
+}
+
+// Global statistics, merged from every live shard
+int shardStats(ShardCluster *cluster, ShardStats *stats) {
+    int i, b;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->minGPA = 4.0f;
+    broadcast(cluster, MSG_STATS, 0, NULL, 0);
+    for (i = 0; i < cluster->shardCount; i++) {
+        ShardStats part;
+        stats->dropped += cluster->shards[i].dropped;
+        if (receive(&cluster->shards[i], &part, sizeof(part)).count < 0) {
+            stats->shardsDown++;
+            continue;
+        }
+        stats->students += part.students;
+        stats->courses += part.courses;
+        stats->credits += part.credits;
+        stats->gpaSum += part.gpaSum;
+        stats->gpaSquares += part.gpaSquares;
+        if (part.students > 0 && part.minGPA < stats->minGPA) stats->minGPA = part.minGPA;
+        if (part.maxGPA > stats->maxGPA) stats->maxGPA = part.maxGPA;
+        for (b = 0; b < SHARD_GPA_BUCKETS; b++) stats->histogram[b] += part.histogram[b];
+    }
+    if (stats->students == 0) stats->minGPA = 0.0f;
+    return stats->shardsDown == 0 && stats->dropped == 0;
+}
+
+// Median GPA to the nearest 0.1, from the merged histogram
+float shardMedianGPA(const ShardStats *stats) {
+    long long seen = 0;
+    int b;
+
+    for (b = 0; b < SHARD_GPA_BUCKETS; b++) {
+        seen += stats->histogram[b];
+        if (seen * 2 >= stats->students && stats->students > 0) return b / 10.0f;
+    }
+    return 0.0f;
+}
+
+// Gather up to max entries from every shard into one array; returns the count
+static int gather(ShardCluster *cluster, int type, int max, const void *payload, int size, RankEntry **all) {
+    int total = 0;
+    int i;
+
+    *all = malloc(sizeof(RankEntry) * (size_t)(max > 0 ? max : 1) * cluster->shardCount);
+    if (*all == NULL) return -1;
+    broadcast(cluster, type, max, payload, size);
+    for (i = 0; i < cluster->shardCount; i++) {
+        Message reply = receive(&cluster->shards[i], *all + total, max * (int)sizeof(RankEntry));
+        if (reply.count > 0) total += reply.count;
+    }
+    return total;
+}
+
+// Best n students across all live shards, in rank order; returns how many
+int shardTopN(ShardCluster *cluster, int n, RankEntry *top) {
+    RankEntry *all;
+    int count = gather(cluster, MSG_TOP, n, NULL, 0, &all);
+
+    if (count < 0) return 0;
+    qsort(all, count, sizeof(RankEntry), compareRank);
+    if (count > n) count = n;
+    memcpy(top, all, sizeof(RankEntry) * count);
+    free(all);
+    return count;
+}
+
+// Students whose name contains text (any case), up to max, in rank order
+int shardFindName(ShardCluster *cluster, const char *text, RankEntry *matches, int max) {
+    RankEntry *all;
+    int count = gather(cluster, MSG_FIND, max, text, (int)strlen(text), &all);
+
+    if (count < 0) return 0;
+    qsort(all, count, sizeof(RankEntry), compareRank);
+    if (count > max) count = max;
+    memcpy(matches, all, sizeof(RankEntry) * count);
+    free(all);
+    return count;
+}
@@ -0,0 +1,69 @@
+#ifndef GPA_SHARD_H
+#define GPA_SHARD_H
+
+#include <sys/types.h>
+#include "gpa_core.h"
+#include "gpa_rank.h"
+
+// Sharded roster over local worker processes (POSIX only). Students are
+// partitioned by id modulo the shard count; each worker is a forked
+// process that owns its students and answers requests over a socketpair.
+// The coordinator routes single-student requests to the owning shard and
+// fans global queries out to every shard at once, merging the partial
+// results. A worker that dies only takes its own students with it: later
+// queries skip it and report how many shards were down. A worker that
+// runs out of memory keeps going but says how many students it could not
+// store; the coordinator reads those replies in the background and
+// reports the total as dropped.
+
+#define SHARD_MAX 64
+#define SHARD_GPA_BUCKETS 41        // 0.0, 0.1, ... 4.0
+#define SHARD_ADD_BATCH 64          // Students buffered per shard before sending
+#define SHARD_ACK_WINDOW 64         // Add batches sent before their replies must be read
+
+typedef struct {
+    long long students;
+    long long courses;
+    long long credits;
+    double gpaSum;
+    double gpaSquares;
+    float minGPA, maxGPA;
+    long long histogram[SHARD_GPA_BUCKETS];     // Students per 0.1 of GPA
+    int shardsDown;
+    long long dropped;          // Students a worker could not store
+} ShardStats;
+
+typedef struct {
+    unsigned int id;
+    Student student;
+} ShardStudent;
+
+typedef struct {
+    pid_t pid;
+    int fd;                 // -1 once the worker is down
+    ShardStudent *pending;
+    int pendingCount;
+    int unacked;            // Add batches whose reply has not been read yet
+    long long dropped;
+} Shard;
+
+typedef struct {
+    Shard shards[SHARD_MAX];
+    int shardCount;
+} ShardCluster;
+
+int shardStart(ShardCluster *cluster, int shardCount);
+void shardStop(ShardCluster *cluster);
+int shardAlive(const ShardCluster *cluster, int shard);
+int shardOf(const ShardCluster *cluster, unsigned int id);
+
+int shardAddStudent(ShardCluster *cluster, unsigned int id, const Student *student);
+int shardFlush(ShardCluster *cluster);
+int shardGetStudent(ShardCluster *cluster, unsigned int id, Student *student);
+
+int shardStats(ShardCluster *cluster, ShardStats *stats);
+float shardMedianGPA(const ShardStats *stats);
+int shardTopN(ShardCluster *cluster, int n, RankEntry *top);
+int shardFindName(ShardCluster *cluster, const char *text, RankEntry *matches, int max);
+
+#endif
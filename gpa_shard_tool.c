@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L
+#include <ctype.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_rank.h"
+#include "gpa_roster_gen.h"
+#include "gpa_shard.h"
+#include "gpa_timer.h"
+
+// Loads a generated roster into local shard workers, runs the global
+// queries and, with --verify, checks them against a single-process
+// computation over the same roster. --kill-shard shows a worker failure.
+
+typedef struct {
+    RankEntry *entries;
+    int count, max;
+} TopList;
+
+static int collectTop(void *context, long long rank, const RankEntry *entry) {
+    TopList *list = context;
+    (void)rank;
+    list->entries[list->count++] = *entry;
+    return list->count < list->max;
+}
+
+// Reference for the find query: lowerText is already lower case
+static int nameContains(const char *name, const char *lowerText) {
+    size_t length = strlen(lowerText);
+    for (; *name != '\0'; name++) {
+        size_t i = 0;
+        while (i < length && tolower((unsigned char)name[i]) == lowerText[i]) i++;
+        if (i == length) return 1;
+    }
+    return length == 0;
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what) {
+    printf("{\"check\":\"%s\",\"ok\":%s}\n", what, ok ? "true" : "false");
+    if (!ok) failures++;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--students N] [--shards N] [--top N] [--seed N] [--verify] [--kill-shard K]\n"
+            "  --students N    roster size (default 200000)\n"
+            "  --shards N      worker processes (default 4, max %d)\n"
+            "  --top N         size of the top-N query (default 10)\n"
+            "  --verify        compare every answer with a single-process computation\n"
+            "  --kill-shard K  kill worker K after loading and query the rest\n",
+            program, SHARD_MAX);
+}
+
+int main(int argc, char **argv) {
+    RosterGenOptions options;
+    RosterGen gen;
+    ShardCluster cluster;
+    ShardStats stats;
+    int students = 200000, shards = 4, topN = 10, verify = 0, killShard = -1;
+
+    rosterGenDefaults(&options);
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--students") == 0 && value != NULL) {
+            students = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--shards") == 0 && value != NULL) {
+            shards = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && value != NULL) {
+            topN = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value != NULL) {
+            options.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--kill-shard") == 0 && value != NULL) {
+            killShard = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (students < 1 || topN < 1 || shards < 1 || shards > SHARD_MAX || killShard >= shards) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!shardStart(&cluster, shards)) {
+        fprintf(stderr, "Cannot start %d workers\n", shards);
+        return 1;
+    }
+
+    // Load: the coordinator keeps a copy only when verifying
+    Student *roster = verify ? malloc(sizeof(Student) * students) : NULL;
+    Student *student = malloc(sizeof(Student));
+    if ((verify && roster == NULL) || student == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        shardStop(&cluster);
+        return 1;
+    }
+    rosterGenInit(&gen, &options);
+    long long start = nowNanoseconds();
+    for (int i = 0; i < students; i++) {
+        rosterGenStudent(&gen, verify ? &roster[i] : student);
+        shardAddStudent(&cluster, (unsigned int)i, verify ? &roster[i] : student);
+    }
+    shardFlush(&cluster);
+    long long loaded = nowNanoseconds();
+
+    if (killShard >= 0) {
+        kill(cluster.shards[killShard].pid, SIGKILL);
+    }
+
+    // Global statistics
+    shardStats(&cluster, &stats);
+    long long statsDone = nowNanoseconds();
+    double mean = stats.students > 0 ? stats.gpaSum / stats.students : 0.0;
+    double variance = stats.students > 0 ? stats.gpaSquares / stats.students - mean * mean : 0.0;
+    printf("{\"query\":\"stats\",\"students\":%lld,\"courses\":%lld,\"mean_gpa\":%.4f,\"stddev\":%.4f,"
+           "\"median_gpa\":%.1f,\"min_gpa\":%.2f,\"max_gpa\":%.2f,\"shards_down\":%d,\"dropped\":%lld,\"ms\":%.2f}\n",
+           stats.students, stats.courses, mean, variance > 0.0 ? sqrt(variance) : 0.0, shardMedianGPA(&stats),
+           stats.minGPA, stats.maxGPA, stats.shardsDown, stats.dropped, (statsDone - loaded) / 1e6);
+
+    // Global top N
+    RankEntry *top = malloc(sizeof(RankEntry) * topN);
+    if (top == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        shardStop(&cluster);
+        return 1;
+    }
+    long long topStart = nowNanoseconds();
+    int topCount = shardTopN(&cluster, topN, top);
+    long long topDone = nowNanoseconds();
+    for (int i = 0; i < topCount && i < 10; i++) {
+        printf("{\"top\":%d,\"id\":%u,\"name\":\"%s\",\"gpa\":%.3f,\"credits\":%d}\n", i + 1, top[i].id,
+               top[i].name, top[i].gpa, top[i].credits);
+    }
+    printf("{\"query\":\"top\",\"n\":%d,\"returned\":%d,\"ms\":%.2f}\n", topN, topCount, (topDone - topStart) / 1e6);
+
+    // Point lookups go to one shard each
+    int lookups = students < 10000 ? students : 10000;
+    int found = 0;
+    long long getStart = nowNanoseconds();
+    for (int i = 0; i < lookups; i++) {
+        unsigned int id = (unsigned int)((i * 2654435761u) % (unsigned int)students);
+        found += shardGetStudent(&cluster, id, student) == 1;
+    }
+    long long getDone = nowNanoseconds();
+    printf("{\"query\":\"get\",\"lookups\":%d,\"found\":%d,\"us_per_lookup\":%.2f}\n", lookups, found,
+           (getDone - getStart) / 1e3 / lookups);
+
+    const char *findText = "bab";     // Lower case, as nameContains expects
+    RankEntry matches[20];
+    long long findStart = nowNanoseconds();
+    int matchCount = shardFindName(&cluster, findText, matches, (int)(sizeof(matches) / sizeof(matches[0])));
+    printf("{\"query\":\"find\",\"text\":\"%s\",\"returned\":%d,\"ms\":%.2f}\n", findText, matchCount,
+           (nowNanoseconds() - findStart) / 1e6);
+    printf("{\"summary\":true,\"students\":%d,\"shards\":%d,\"load_ms\":%.1f,\"students_per_sec\":%.0f}\n",
+           students, shards, (loaded - start) / 1e6, students * 1e9 / (loaded - start));
+
+    if (verify) {
+        // Reference answers from one process, over the live shards' students
+        RankOptions rankOptions;
+        RankSorter sorter, findSorter;
+        TopList expected, expectedMatches;
+        long long count = 0;
+        double gpaSum = 0.0;
+        int lookupsOk = 1;
+
+        rankDefaults(&rankOptions);
+        rankOptions.memoryBudget = (size_t)students * (sizeof(RankEntry) + 64) + RANK_MIN_MEMORY;
+        expected.entries = malloc(sizeof(RankEntry) * topN);
+        expectedMatches.entries = malloc(sizeof(matches));
+        if (expected.entries == NULL || expectedMatches.entries == NULL || !rankInit(&sorter, &rankOptions) ||
+            !rankInit(&findSorter, &rankOptions)) {
+            fprintf(stderr, "Out of memory\n");
+            shardStop(&cluster);
+            return 1;
+        }
+        expected.count = 0;
+        expected.max = topN;
+        expectedMatches.count = 0;
+        expectedMatches.max = (int)(sizeof(matches) / sizeof(matches[0]));
+        for (int i = 0; i < students; i++) {
+            if (!shardAlive(&cluster, shardOf(&cluster, (unsigned int)i))) continue;
+            count++;
+            gpaSum += computeStudentGPA(&roster[i], NULL);
+            rankAddStudent(&sorter, (unsigned int)i, &roster[i]);
+            if (nameContains(roster[i].name, findText)) rankAddStudent(&findSorter, (unsigned int)i, &roster[i]);
+        }
+        rankFinish(&sorter, collectTop, &expected);
+        rankFree(&sorter);
+        rankFinish(&findSorter, collectTop, &expectedMatches);
+        rankFree(&findSorter);
+
+        for (int i = 0; i < lookups; i++) {
+            unsigned int id = (unsigned int)((i * 2654435761u) % (unsigned int)students);
+            int result = shardGetStudent(&cluster, id, student);
+            if (!shardAlive(&cluster, shardOf(&cluster, id))) {
+                lookupsOk = lookupsOk && result == -1;
+            } else {
+                lookupsOk = lookupsOk && result == 1 && strcmp(student->name, roster[id].name) == 0 &&
+                            student->courseCount == roster[id].courseCount && student->gpa == roster[id].gpa;
+            }
+        }
+
+        int topOk = expected.count == topCount;
+        for (int i = 0; topOk && i < topCount; i++) {
+            topOk = top[i].id == expected.entries[i].id && top[i].gpa == expected.entries[i].gpa;
+        }
+        int findOk = expectedMatches.count == matchCount;
+        for (int i = 0; findOk && i < matchCount; i++) {
+            findOk = matches[i].id == expectedMatches.entries[i].id && matches[i].gpa == expectedMatches.entries[i].gpa;
+        }
+        check(stats.students == count, "student_count");
+        check(stats.students > 0 && fabs(stats.gpaSum / stats.students - gpaSum / count) < 1e-6, "mean_gpa");
+        check(topOk, "top_n");
+        check(findOk, "find");
+        check(lookupsOk, "lookups");
+        check(stats.shardsDown == (killShard >= 0), "shards_down");
+        check(stats.dropped == 0, "dropped");
+        free(expected.entries);
+        free(expectedMatches.entries);
+    }
+
+    shardStop(&cluster);
+    free(top);
+    free(student);
+    free(roster);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_stats.h"
+#include "gpa_timer.h"
+
+#if defined(_MSC_VER)
+#include <windows.h>    // InterlockedCompareExchangePointer
+#endif
+
+STATS_THREAD StatsBlock *statsLocal = NULL;
+static StatsBlock *volatile statsHead = NULL;
+
+static const char *const opNames[STAT_OP_COUNT] = {
+    "add_course", "calculate_gpa", "display_student", "switch_student", "import_roster", "export_roster"
+};
+
+static const char *const counterNames[STAT_COUNTER_COUNT] = {
+    "courses_added", "courses_rejected", "rows_imported", "rows_skipped"
+};
+
+const char *statsOpName(StatOp op) {
+    return opNames[op];
+}
+
+const char *statsCounterName(StatCounter counter) {
+    return counterNames[counter];
+}
+
+unsigned long long statsClockNanoseconds(void) {
+    return (unsigned long long)nowNanoseconds();
+}
+
+// Slow path: allocate this thread's block and push it onto the global list
+StatsBlock *statsRegisterThread(void) {
+    StatsBlock *block = calloc(1, sizeof(StatsBlock));
+    if (block == NULL) {
+        fprintf(stderr, "gpa_stats: out of memory\n");
+        abort();
+    }
+
+#if defined(_MSC_VER)
+    do {
+        block->next = statsHead;
+    } while (InterlockedCompareExchangePointer((PVOID volatile *)&statsHead, block, block->next) != block->next);
+#else
+    do {
+        block->next = statsHead;
+    } while (!__sync_bool_compare_and_swap(&statsHead, block->next, block));
+#endif
+
+    statsLocal = block;
+    return block;
+}
+
+// Ticks per nanosecond, measured once against the monotonic clock
+double statsTicksPerNanosecond(void) {
+#ifdef STATS_HAVE_TSC
+    static double ratio = 0.0;
+    if (ratio == 0.0) {
+        long long startNs = nowNanoseconds();
+        unsigned long long startTicks = statsTicks();
+        long long elapsed;
+        do {
+            elapsed = nowNanoseconds() - startNs;
+        } while (elapsed < 10000000);
+        ratio = (double)(statsTicks() - startTicks) / (double)elapsed;
+    }
+    return ratio;
+#else
+    return 1.0;
+#endif
+}
+
+// Upper bound (exclusive) of a histogram bucket, in ticks
+static unsigned long long bucketUpperBound(int bucket) {
+    int group = bucket / STATS_SUB_BUCKETS;
+    int sub = bucket % STATS_SUB_BUCKETS;
+    if (group == 0) return (unsigned long long)bucket + 1;
+    return (unsigned long long)(STATS_SUB_BUCKETS + sub + 1) << (group - 1);
+}
+
+// Prometheus needs the same bucket set on every scrape, so statsDump writes
+// fixed bounds in nanoseconds (the log-linear layout, read as ns) instead
+// of the tick bounds, which move with each run's clock calibration. A
+// tick bucket counts under the first bound that its upper edge fits in;
+// anything over 2^39 ns (minutes) only counts in +Inf.
+#define STATS_DUMP_BUCKETS (40 * STATS_SUB_BUCKETS)
+
+// Prometheus text format: one histogram per operation plus the counters
+void statsDump(FILE *out) {
+    static unsigned long long buckets[STATS_BUCKETS];
+    double ticksPerNs = statsTicksPerNanosecond();
+    StatsBlock *block;
+    int op, counter, b, t;
+
+    fprintf(out, "# HELP gpa_op_latency_ns Latency of sampled grading operations in nanoseconds.\n");
+    fprintf(out, "# TYPE gpa_op_latency_ns histogram\n");
+    for (op = 0; op < STAT_OP_COUNT; op++) {
+        unsigned long long count = 0, sumTicks = 0, cumulative = 0;
+
+        memset(buckets, 0, sizeof(buckets));
+        for (block = statsHead; block != NULL; block = block->next) {
+            count += block->count[op];
+            sumTicks += block->sumTicks[op];
+            for (b = 0; b < STATS_BUCKETS; b++) {
+                buckets[b] += block->buckets[op][b];
+            }
+        }
+
+        for (b = 0, t = 0; b < STATS_DUMP_BUCKETS; b++) {
+            unsigned long long le = bucketUpperBound(b);
+            while (t < STATS_BUCKETS && bucketUpperBound(t) / ticksPerNs <= (double)le) {
+                cumulative += buckets[t++];
+            }
+            fprintf(out, "gpa_op_latency_ns_bucket{op=\"%s\",le=\"%llu\"} %llu\n", opNames[op], le, cumulative);
+        }
+        fprintf(out, "gpa_op_latency_ns_bucket{op=\"%s\",le=\"+Inf\"} %llu\n", opNames[op], count);
+        fprintf(out, "gpa_op_latency_ns_sum{op=\"%s\"} %.1f\n", opNames[op], sumTicks / ticksPerNs);
+        fprintf(out, "gpa_op_latency_ns_count{op=\"%s\"} %llu\n", opNames[op], count);
+    }
+
+    fprintf(out, "# HELP gpa_op_events_total Grading operations, timed or not.\n");
+    fprintf(out, "# TYPE gpa_op_events_total counter\n");
+    for (op = 0; op < STAT_OP_COUNT; op++) {
+        unsigned long long total = 0;
+        for (block = statsHead; block != NULL; block = block->next) {
+            total += block->events[op];
+        }
+        fprintf(out, "gpa_op_events_total{op=\"%s\"} %llu\n", opNames[op], total);
+    }
+
+    fprintf(out, "# HELP gpa_events_total Grading events.\n");
+    fprintf(out, "# TYPE gpa_events_total counter\n");
+    for (counter = 0; counter < STAT_COUNTER_COUNT; counter++) {
+        unsigned long long total = 0;
+        for (block = statsHead; block != NULL; block = block->next) {
+            total += block->counters[counter];
+        }
+        fprintf(out, "gpa_events_total{event=\"%s\"} %llu\n", counterNames[counter], total);
+    }
+}
+
+// Zero every thread's block; blocks stay registered
+void statsReset(void) {
+    StatsBlock *block;
+    for (block = statsHead; block != NULL; block = block->next) {
+        StatsBlock *next = block->next;
+        memset(block, 0, sizeof(*block));
+        block->next = next;
+    }
+}
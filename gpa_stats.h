@@ -0,0 +1,140 @@
+#ifndef GPA_STATS_H
+#define GPA_STATS_H
+
+#include <stdio.h>
+
+// Hot-path instrumentation: per-thread event counters and log-linear
+// latency histograms. Compiled in only with -DGPA_STATS; otherwise every
+// STATS_* macro expands to nothing.
+//
+// Every event is counted, but only one in 2^STATS_SAMPLE_SHIFT is timed:
+// reading the clock costs far more than the histogram update, so sampling
+// keeps the amortized cost per event at a few nanoseconds.
+
+// Timed operations
+typedef enum {
+    STAT_ADD_COURSE,
+    STAT_CALCULATE_GPA,
+    STAT_DISPLAY_STUDENT,
+    STAT_SWITCH_STUDENT,
+    STAT_IMPORT_ROSTER,
+    STAT_EXPORT_ROSTER,
+    STAT_OP_COUNT
+} StatOp;
+
+// Plain event counters
+typedef enum {
+    STAT_COURSES_ADDED,
+    STAT_COURSES_REJECTED,
+    STAT_ROWS_IMPORTED,
+    STAT_ROWS_SKIPPED,
+    STAT_COUNTER_COUNT
+} StatCounter;
+
+#ifndef STATS_SAMPLE_SHIFT
+#define STATS_SAMPLE_SHIFT 4
+#endif
+
+// 16 linear sub-buckets per power of two
+#define STATS_SUB_BITS 4
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_BUCKETS (64 * STATS_SUB_BUCKETS)
+
+// One per thread, linked into a global list on first use
+typedef struct StatsBlock {
+    unsigned long long counters[STAT_COUNTER_COUNT];
+    unsigned long long events[STAT_OP_COUNT];    // All events
+    unsigned long long count[STAT_OP_COUNT];     // Timed samples
+    unsigned long long sumTicks[STAT_OP_COUNT];
+    unsigned int buckets[STAT_OP_COUNT][STATS_BUCKETS];
+    struct StatsBlock *next;
+} StatsBlock;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define STATS_THREAD __declspec(thread)
+#else
+#define STATS_THREAD __thread
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if !defined(_MSC_VER)
+#include <x86intrin.h>
+#endif
+#define STATS_HAVE_TSC 1
+#endif
+
+extern STATS_THREAD StatsBlock *statsLocal;
+StatsBlock *statsRegisterThread(void);
+const char *statsOpName(StatOp op);
+const char *statsCounterName(StatCounter counter);
+unsigned long long statsClockNanoseconds(void);
+double statsTicksPerNanosecond(void);
+void statsDump(FILE *out);
+void statsReset(void);
+
+// Raw timestamp: TSC where available, else the monotonic clock in ns
+static inline unsigned long long statsTicks(void) {
+#ifdef STATS_HAVE_TSC
+    return __rdtsc();
+#else
+    return statsClockNanoseconds();
+#endif
+}
+
+static inline int statsBucket(unsigned long long ticks) {
+    int msb;
+    if (ticks < STATS_SUB_BUCKETS) return (int)ticks;
+#if defined(_MSC_VER)
+    {
+        unsigned long index;
+        _BitScanReverse64(&index, ticks);
+        msb = (int)index;
+    }
+#else
+    msb = 63 - __builtin_clzll(ticks);
+#endif
+    return (msb - STATS_SUB_BITS + 1) * STATS_SUB_BUCKETS +
+           (int)((ticks >> (msb - STATS_SUB_BITS)) & (STATS_SUB_BUCKETS - 1));
+}
+
+static inline StatsBlock *statsBlock(void) {
+    StatsBlock *block = statsLocal;
+    return block != NULL ? block : statsRegisterThread();
+}
+
+static inline void statsRecord(StatOp op, unsigned long long ticks) {
+    StatsBlock *block = statsBlock();
+    block->count[op]++;
+    block->sumTicks[op] += ticks;
+    block->buckets[op][statsBucket(ticks)]++;
+}
+
+// Count an event; returns a start timestamp if it is sampled, else 0
+static inline unsigned long long statsBegin(StatOp op) {
+    StatsBlock *block = statsBlock();
+    if ((block->events[op]++ & ((1ULL << STATS_SAMPLE_SHIFT) - 1)) != 0) return 0;
+    return statsTicks() | 1;   // Never 0, at the cost of one tick
+}
+
+static inline void statsEnd(StatOp op, unsigned long long start) {
+    if (start != 0) statsRecord(op, statsTicks() - start);
+}
+
+static inline void statsAdd(StatCounter counter, unsigned long long n) {
+    statsBlock()->counters[counter] += n;
+}
+
+#ifdef GPA_STATS
+#define STATS_BEGIN(op) unsigned long long statsStart_##op = statsBegin(op)
+#define STATS_END(op) statsEnd(op, statsStart_##op)
+#define STATS_ADD(counter, n) statsAdd(counter, n)
+#define STATS_DUMP(out) statsDump(out)
+#else
+#define STATS_BEGIN(op) ((void)0)
+#define STATS_END(op) ((void)0)
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_DUMP(out) ((void)0)
+#endif
+
+#endif
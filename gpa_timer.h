@@ -0,0 +1,29 @@
+#ifndef GPA_TIMER_H
+#define GPA_TIMER_H
+
+// Monotonic nanosecond clock for the headless tools. On POSIX, includers
+// define _POSIX_C_SOURCE 200809L before their first #include so that a
+// strict -std=c99 build sees clock_gettime.
+#ifdef _WIN32
+#include <windows.h>
+
+static inline long long nowNanoseconds(void) {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (long long)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+#else
+#include <time.h>
+
+static inline long long nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+#endif
+
+#endif
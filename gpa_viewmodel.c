@@ -0,0 +1,251 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_viewmodel.h"
+
+int viewInit(ViewModel *vm, const ViewOps *ops, void *context, Student *students, int capacity) {
+    memset(vm, 0, sizeof(*vm));
+    vm->ops = ops;
+    vm->context = context;
+    vm->students = students;
+    vm->capacity = capacity;
+    vm->studentRows = malloc(sizeof(*vm->studentRows) * capacity);
+    vm->rowShowsGPA = calloc(capacity, 1);
+    vm->rowDirty = calloc(capacity, 1);
+    vm->dirtyFirst = capacity;
+    vm->dirtyLast = -1;
+    vm->selection = -1;
+    vm->courseStudent = -1;
+    vm->courseDirtyFrom = -1;
+    if (vm->studentRows == NULL || vm->rowShowsGPA == NULL || vm->rowDirty == NULL) {
+        viewFree(vm);
+        return 0;
+    }
+    return 1;
+}
+
+void viewFree(ViewModel *vm) {
+    free(vm->studentRows);
+    free(vm->rowShowsGPA);
+    free(vm->rowDirty);
+    vm->studentRows = NULL;
+    vm->rowShowsGPA = NULL;
+    vm->rowDirty = NULL;
+}
+
+void viewBeginBatch(ViewModel *vm) {
+    vm->batchDepth++;
+}
+
+void viewEndBatch(ViewModel *vm) {
+    if (vm->batchDepth > 0 && --vm->batchDepth == 0) {
+        viewFlush(vm);
+    }
+}
+
+// Flush right away unless a batch is open
+static void changed(ViewModel *vm) {
+    if (vm->batchDepth == 0) viewFlush(vm);
+}
+
+static void markRowDirty(ViewModel *vm, int index) {
+    if (vm->rowDirty[index]) return;
+    vm->rowDirty[index] = 1;
+    vm->dirtyCount++;
+    if (index < vm->dirtyFirst) vm->dirtyFirst = index;
+    if (index > vm->dirtyLast) vm->dirtyLast = index;
+}
+
+static void formatStudentRow(ViewModel *vm, int index) {
+    const Student *student = &vm->students[index];
+    if (vm->rowShowsGPA[index]) {
+        formatStudentEntry(vm->studentRows[index], LIST_ROW_LENGTH, student);
+    } else {
+        strcpy(vm->studentRows[index], student->name);
+    }
+}
+
+static void flushStudentRows(ViewModel *vm) {
+    int i;
+
+    for (i = vm->dirtyFirst; i <= vm->dirtyLast; i++) {
+        if (vm->rowDirty[i]) formatStudentRow(vm, i);
+    }
+
+    // Many scattered changes: one reset beats many small replaces
+    if (vm->rowsShown == 0 || vm->dirtyCount * 2 > vm->studentCount) {
+        vm->ops->resetRows(vm->context, VIEW_STUDENT_LIST, (const char (*)[LIST_ROW_LENGTH])vm->studentRows,
+                           vm->studentCount);
+        memset(vm->rowDirty + vm->dirtyFirst, 0, (size_t)(vm->dirtyLast - vm->dirtyFirst + 1));
+    } else {
+        i = vm->dirtyFirst;
+        while (i <= vm->dirtyLast) {
+            int runStart;
+            if (!vm->rowDirty[i]) {
+                i++;
+                continue;
+            }
+            runStart = i;
+            while (i <= vm->dirtyLast && vm->rowDirty[i]) {
+                vm->rowDirty[i] = 0;
+                i++;
+            }
+            vm->ops->replaceRows(vm->context, VIEW_STUDENT_LIST, runStart,
+                                 (const char (*)[LIST_ROW_LENGTH])vm->studentRows + runStart, i - runStart);
+        }
+    }
+
+    vm->rowsShown = vm->studentCount;
+    vm->dirtyCount = 0;
+    vm->dirtyFirst = vm->capacity;
+    vm->dirtyLast = -1;
+
+    // Listboxes drop the selection when rows are replaced
+    if (vm->selection >= 0) vm->selectionDirty = 1;
+}
+
+static void flushCourseRows(ViewModel *vm) {
+    const Student *student = vm->courseStudent >= 0 ? &vm->students[vm->courseStudent] : NULL;
+    int from = vm->coursesReset ? 0 : vm->courseDirtyFrom;
+    int i;
+
+    for (i = from; i < vm->courseRowCount; i++) {
+        formatCourseEntry(vm->courseRows[i], LIST_ROW_LENGTH, &student->courses[i]);
+    }
+
+    if (vm->coursesReset) {
+        vm->ops->resetRows(vm->context, VIEW_COURSE_LIST, (const char (*)[LIST_ROW_LENGTH])vm->courseRows,
+                           vm->courseRowCount);
+    } else if (vm->courseRowCount > from) {
+        vm->ops->replaceRows(vm->context, VIEW_COURSE_LIST, from,
+                             (const char (*)[LIST_ROW_LENGTH])vm->courseRows + from, vm->courseRowCount - from);
+    }
+
+    vm->coursesReset = 0;
+    vm->courseDirtyFrom = -1;
+}
+
+// Push everything dirty to the view in one begin/end update
+void viewFlush(ViewModel *vm) {
+    int coursesDirty = vm->coursesReset || vm->courseDirtyFrom >= 0;
+
+    if (vm->dirtyCount == 0 && !coursesDirty && !vm->outputDirty && !vm->selectionDirty) return;
+
+    vm->ops->beginUpdate(vm->context);
+    if (vm->dirtyCount > 0) flushStudentRows(vm);
+    if (coursesDirty) flushCourseRows(vm);
+    if (vm->outputDirty) {
+        vm->ops->setOutput(vm->context, vm->output);
+        vm->outputDirty = 0;
+    }
+    if (vm->selectionDirty) {
+        vm->ops->setSelection(vm->context, VIEW_STUDENT_LIST, vm->selection);
+        vm->selectionDirty = 0;
+    }
+    vm->ops->endUpdate(vm->context);
+}
+
+// New students show their plain name until their GPA is calculated
+void viewStudentsAdded(ViewModel *vm, int first, int count) {
+    int i;
+
+    for (i = first; i < first + count && i < vm->capacity; i++) {
+        vm->rowShowsGPA[i] = 0;
+        markRowDirty(vm, i);
+    }
+    if (i > vm->studentCount) vm->studentCount = i;
+    changed(vm);
+}
+
+// The student's GPA was (re)calculated
+void viewStudentChanged(ViewModel *vm, int index) {
+    if (index < 0 || index >= vm->studentCount) return;
+    vm->rowShowsGPA[index] = 1;
+    markRowDirty(vm, index);
+    changed(vm);
+}
+
+void viewSelectStudent(ViewModel *vm, int index) {
+    vm->selection = index;
+    vm->selectionDirty = 1;
+    changed(vm);
+}
+
+// Show all courses of a student
+void viewShowCourses(ViewModel *vm, int index) {
+    vm->courseStudent = index;
+    vm->courseRowCount = index >= 0 ? vm->students[index].courseCount : 0;
+    vm->coursesReset = 1;
+    changed(vm);
+}
+
+// Courses were added to the student's list
+void viewCoursesAppended(ViewModel *vm, int index) {
+    int count;
+
+    if (index != vm->courseStudent) {
+        viewShowCourses(vm, index);
+        return;
+    }
+
+    count = vm->students[index].courseCount;
+    if (count > vm->courseRowCount) {
+        if (!vm->coursesReset && vm->courseDirtyFrom < 0) vm->courseDirtyFrom = vm->courseRowCount;
+        vm->courseRowCount = count;
+    }
+    changed(vm);
+}
+
+void viewClearCourses(ViewModel *vm, int index) {
+    vm->courseStudent = index;
+    vm->courseRowCount = 0;
+    vm->coursesReset = 1;
+    changed(vm);
+}
+
+void viewSetOutput(ViewModel *vm, const char *text) {
+    strncpy(vm->output, text, LIST_ROW_LENGTH - 1);
+    vm->output[LIST_ROW_LENGTH - 1] = '\0';
+    vm->outputDirty = 1;
+    changed(vm);
+}
+
+// Counting view: records how much work reached it
+static void countBegin(void *context) {
+    ((ViewCounters *)context)->flushes++;
+}
+
+static void countEnd(void *context) {
+    (void)context;
+}
+
+static void countReset(void *context, ViewList list, const char (*rows)[LIST_ROW_LENGTH], int count) {
+    ViewCounters *counters = context;
+    (void)list;
+    (void)rows;
+    counters->resets++;
+    counters->rowsSent += count;
+}
+
+static void countReplace(void *context, ViewList list, int first, const char (*rows)[LIST_ROW_LENGTH], int count) {
+    ViewCounters *counters = context;
+    (void)list;
+    (void)first;
+    (void)rows;
+    counters->replaces++;
+    counters->rowsSent += count;
+}
+
+static void countSelection(void *context, ViewList list, int index) {
+    (void)list;
+    (void)index;
+    ((ViewCounters *)context)->selections++;
+}
+
+static void countOutput(void *context, const char *text) {
+    (void)text;
+    ((ViewCounters *)context)->outputs++;
+}
+
+const ViewOps countingViewOps = {
+    countBegin, countEnd, countReset, countReplace, countSelection, countOutput
+};
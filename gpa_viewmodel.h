@@ -0,0 +1,88 @@
+#ifndef GPA_VIEWMODEL_H
+#define GPA_VIEWMODEL_H
+
+#include "gpa_core.h"
+
+// Toolkit-independent view model for the student list, the course list
+// and the output box. Changes only mark rows dirty; row strings are
+// formatted and cached at flush time, and a flush pushes each run of
+// changed rows to the view in one call. Between viewBeginBatch() and
+// viewEndBatch() nothing reaches the view, so a bulk change costs one
+// refresh instead of one per row.
+
+#define LIST_ROW_LENGTH 256
+
+typedef enum {
+    VIEW_STUDENT_LIST,
+    VIEW_COURSE_LIST
+} ViewList;
+
+// Implemented by the front end (Win32 listboxes, a headless mock, ...)
+typedef struct {
+    void (*beginUpdate)(void *context);
+    void (*endUpdate)(void *context);
+    // Replace the whole list
+    void (*resetRows)(void *context, ViewList list, const char (*rows)[LIST_ROW_LENGTH], int count);
+    // Replace rows first..first+count-1; rows past the end are appended
+    void (*replaceRows)(void *context, ViewList list, int first, const char (*rows)[LIST_ROW_LENGTH], int count);
+    void (*setSelection)(void *context, ViewList list, int index);
+    void (*setOutput)(void *context, const char *text);
+} ViewOps;
+
+typedef struct {
+    const ViewOps *ops;
+    void *context;
+
+    // Student list
+    Student *students;
+    int capacity;
+    int studentCount;
+    char (*studentRows)[LIST_ROW_LENGTH];
+    unsigned char *rowShowsGPA;   // Row reads "name (GPA: x.xx)" instead of "name"
+    unsigned char *rowDirty;
+    int dirtyFirst, dirtyLast, dirtyCount;
+    int rowsShown;                // Rows the view currently holds
+    int selection;
+    int selectionDirty;
+
+    // Course list of the displayed student
+    int courseStudent;
+    char courseRows[MAX_COURSES][LIST_ROW_LENGTH];
+    int courseRowCount;
+    int courseDirtyFrom;          // First changed row, -1 if none
+    int coursesReset;
+
+    // Output box
+    char output[LIST_ROW_LENGTH];
+    int outputDirty;
+
+    int batchDepth;
+} ViewModel;
+
+// Counts what reached the view; doubles as a no-op view for headless runs
+typedef struct {
+    int flushes;
+    int resets;
+    int replaces;
+    long long rowsSent;
+    int selections;
+    int outputs;
+} ViewCounters;
+
+extern const ViewOps countingViewOps;
+
+int viewInit(ViewModel *vm, const ViewOps *ops, void *context, Student *students, int capacity);
+void viewFree(ViewModel *vm);
+void viewBeginBatch(ViewModel *vm);
+void viewEndBatch(ViewModel *vm);
+void viewFlush(ViewModel *vm);
+
+void viewStudentsAdded(ViewModel *vm, int first, int count);
+void viewStudentChanged(ViewModel *vm, int index);
+void viewSelectStudent(ViewModel *vm, int index);
+void viewShowCourses(ViewModel *vm, int index);
+void viewCoursesAppended(ViewModel *vm, int index);
+void viewClearCourses(ViewModel *vm, int index);
+void viewSetOutput(ViewModel *vm, const char *text);
+
+#endif
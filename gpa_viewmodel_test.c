@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpa_check.h"
+#include "gpa_import.h"
+#include "gpa_roster_gen.h"
+#include "gpa_viewmodel.h"
+
+// Headless checks of the view model against the counting view: how many
+// flushes, resets and row replaces each kind of change costs. Prints each
+// failed check and exits with status 1 if any failed.
+
+#define IMPORT_STUDENTS 20000
+#define COURSES_PER_STUDENT 5
+
+// A synthetic roster of 100,000 courses, imported as the UI would import it
+static Student *importTestRoster(int *count, int *courses) {
+    RosterGenOptions options;
+    RosterGen gen;
+    Student *generated = malloc(sizeof(Student) * IMPORT_STUDENTS);
+    Student *imported = malloc(sizeof(Student) * IMPORT_STUDENTS);
+    size_t length;
+    char *text;
+
+    if (generated == NULL || imported == NULL) return NULL;
+    rosterGenDefaults(&options);
+    options.minCourses = options.maxCourses = COURSES_PER_STUDENT;
+    rosterGenInit(&gen, &options);
+    rosterGenFill(&gen, generated, IMPORT_STUDENTS);
+    text = exportRoster(generated, IMPORT_STUDENTS, &length);
+    free(generated);
+    if (text == NULL) return NULL;
+
+    *count = importRoster(text, length, imported, IMPORT_STUDENTS, NULL);
+    *courses = 0;
+    for (int i = 0; i < *count; i++) *courses += imported[i].courseCount;
+    free(text);
+    return imported;
+}
+
+// Whole import inside one batch: a single flush that resets the list once
+static void checkBatchedImport(Student *students, int count) {
+    ViewModel vm;
+    ViewCounters counters;
+
+    memset(&counters, 0, sizeof(counters));
+    if (!viewInit(&vm, &countingViewOps, &counters, students, count)) return;
+    viewBeginBatch(&vm);
+    for (int i = 0; i < count; i++) {
+        viewStudentsAdded(&vm, i, 1);
+        viewStudentChanged(&vm, i);
+    }
+    CHECK_COUNT("flushes inside the batch", counters.flushes, 0);
+    viewEndBatch(&vm);
+
+    CHECK_COUNT("batched import flushes", counters.flushes, 1);
+    CHECK_COUNT("batched import resets", counters.resets, 1);
+    CHECK_COUNT("batched import replaces", counters.replaces, 0);
+    CHECK_COUNT("batched import rows sent", counters.rowsSent, count);
+    viewFree(&vm);
+}
+
+// Outside a batch every change reaches the view on its own
+static void checkUnbatchedEdits(Student *students, int count) {
+    ViewModel vm;
+    ViewCounters counters;
+    int edits = 100;
+
+    memset(&counters, 0, sizeof(counters));
+    if (!viewInit(&vm, &countingViewOps, &counters, students, count)) return;
+    viewStudentsAdded(&vm, 0, count);
+    memset(&counters, 0, sizeof(counters));
+
+    for (int i = 0; i < edits; i++) viewStudentChanged(&vm, i * 7);
+    CHECK_COUNT("unbatched edit flushes", counters.flushes, edits);
+    CHECK_COUNT("unbatched edit resets", counters.resets, 0);
+    CHECK_COUNT("unbatched edit replaces", counters.replaces, edits);
+    CHECK_COUNT("unbatched edit rows sent", counters.rowsSent, edits);
+
+    // The same edits batched: adjacent rows go out as one replace
+    memset(&counters, 0, sizeof(counters));
+    viewBeginBatch(&vm);
+    for (int i = 0; i < edits; i++) viewStudentChanged(&vm, 1000 + i);
+    viewStudentChanged(&vm, 5000);
+    viewEndBatch(&vm);
+    CHECK_COUNT("batched edit flushes", counters.flushes, 1);
+    CHECK_COUNT("batched edit replaces", counters.replaces, 2);
+    CHECK_COUNT("batched edit rows sent", counters.rowsSent, edits + 1);
+
+    // Changing most rows at once is sent as a reset
+    memset(&counters, 0, sizeof(counters));
+    viewBeginBatch(&vm);
+    for (int i = 0; i < count; i += 2) viewStudentChanged(&vm, i);
+    viewStudentChanged(&vm, 1);
+    viewEndBatch(&vm);
+    CHECK_COUNT("bulk edit resets", counters.resets, 1);
+    CHECK_COUNT("bulk edit replaces", counters.replaces, 0);
+    viewFree(&vm);
+}
+
+// Only the outermost viewEndBatch flushes
+static void checkNestedBatches(Student *students, int count) {
+    ViewModel vm;
+    ViewCounters counters;
+
+    memset(&counters, 0, sizeof(counters));
+    if (!viewInit(&vm, &countingViewOps, &counters, students, count)) return;
+    viewBeginBatch(&vm);
+    viewStudentsAdded(&vm, 0, 10);
+    viewBeginBatch(&vm);
+    viewShowCourses(&vm, 3);
+    viewSelectStudent(&vm, 3);
+    viewSetOutput(&vm, "nested");
+    viewEndBatch(&vm);
+    CHECK_COUNT("flushes after the inner end", counters.flushes, 0);
+    viewEndBatch(&vm);
+
+    CHECK_COUNT("nested batch flushes", counters.flushes, 1);
+    CHECK_COUNT("nested batch resets", counters.resets, 2);
+    CHECK_COUNT("nested batch selections", counters.selections, 1);
+    CHECK_COUNT("nested batch outputs", counters.outputs, 1);
+
+    // An unmatched end neither flushes nor underflows the depth
+    viewEndBatch(&vm);
+    viewSetOutput(&vm, "after");
+    CHECK_COUNT("flushes after an extra end", counters.flushes, 2);
+
+    // Nothing dirty: no flush at all
+    viewBeginBatch(&vm);
+    viewEndBatch(&vm);
+    CHECK_COUNT("empty batch flushes", counters.flushes, 2);
+    viewFree(&vm);
+}
+
+// Appending courses sends only the new rows
+static void checkCourseAppends(Student *students) {
+    ViewModel vm;
+    ViewCounters counters;
+    Student *student = &students[0];
+
+    memset(&counters, 0, sizeof(counters));
+    if (!viewInit(&vm, &countingViewOps, &counters, students, 1)) return;
+    viewShowCourses(&vm, 0);
+    CHECK_COUNT("course list resets", counters.resets, 1);
+    CHECK_COUNT("course rows sent on show", counters.rowsSent, student->courseCount);
+
+    memset(&counters, 0, sizeof(counters));
+    studentAddCourse(student, "TEST 101", 3, "A");
+    viewCoursesAppended(&vm, 0);
+    CHECK_COUNT("course append replaces", counters.replaces, 1);
+    CHECK_COUNT("course append rows sent", counters.rowsSent, 1);
+    viewFree(&vm);
+}
+
+int main(void) {
+    int count, courses;
+    Student *students = importTestRoster(&count, &courses);
+
+    if (students == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    CHECK_COUNT("imported courses", courses, IMPORT_STUDENTS * COURSES_PER_STUDENT);
+
+    checkBatchedImport(students, count);
+    checkUnbatchedEdits(students, count);
+    checkNestedBatches(students, count);
+    checkCourseAppends(students);
+
+    free(students);
+    return checkReport("view model");
+}